@@ -0,0 +1,89 @@
+#include <benchmark/benchmark.h>
+#include "core/clone_extender.hpp"
+#include "core/hash_index.hpp"
+#include <random>
+#include <vector>
+
+using namespace aegis::similarity;
+
+namespace {
+
+/**
+ * Build a token stream where every block of 50 tokens alternates
+ * between shared content (identical hashes in both files) and noise,
+ * giving the extender realistic boundaries to stop at.
+ */
+TokenizedFile make_tokenized(const std::string& path, size_t num_tokens,
+                             uint64_t noise_seed) {
+    std::mt19937_64 rng(noise_seed);
+    TokenizedFile file;
+    file.path = path;
+    file.total_lines = static_cast<uint32_t>(num_tokens / 8 + 1);
+    file.code_lines = file.total_lines;
+    file.tokens.reserve(num_tokens);
+
+    for (size_t i = 0; i < num_tokens; ++i) {
+        const bool shared_block = (i / 50) % 2 == 0;
+
+        NormalizedToken token{};
+        token.type = TokenType::IDENTIFIER;
+        token.normalized_hash = shared_block
+            ? static_cast<uint32_t>(i % 50 + 1)
+            : static_cast<uint32_t>(rng());
+        token.original_hash = token.normalized_hash;
+        token.line = static_cast<uint32_t>(i / 8 + 1);
+        token.column = static_cast<uint16_t>((i % 8) * 6);
+        token.length = 5;
+        file.tokens.push_back(token);
+    }
+    return file;
+}
+
+}  // anonymous namespace
+
+static void BM_CloneExtenderExtendAll(benchmark::State& state) {
+    const size_t num_pairs = static_cast<size_t>(state.range(0));
+    const size_t num_tokens = 4000;
+
+    std::vector<TokenizedFile> files;
+    files.push_back(make_tokenized("a.py", num_tokens, 1));
+    files.push_back(make_tokenized("b.py", num_tokens, 2));
+
+    HashIndex index;
+    index.register_file("a.py");
+    index.register_file("b.py");
+
+    // Seed pairs scattered over the shared blocks
+    std::vector<ClonePair> pairs;
+    for (size_t i = 0; i < num_pairs; ++i) {
+        const uint32_t start = static_cast<uint32_t>((i * 100) % (num_tokens - 200));
+
+        ClonePair pair{};
+        pair.location_a.file_id = 0;
+        pair.location_a.token_start = start;
+        pair.location_a.token_count = 20;
+        pair.location_a.start_line = start / 8 + 1;
+        pair.location_a.end_line = (start + 20) / 8 + 1;
+        pair.location_b = pair.location_a;
+        pair.location_b.file_id = 1;
+        pair.clone_type = CloneType::TYPE_1;
+        pair.similarity = 1.0f;
+        pair.shared_hash = i + 1;
+        pairs.push_back(pair);
+    }
+
+    CloneExtender extender;
+    size_t extended_count = 0;
+    for (auto _ : state) {
+        auto extended = extender.extend_all(pairs, files, index);
+        extended_count = extended.size();
+        benchmark::DoNotOptimize(extended);
+    }
+
+    state.counters["pairs/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations()) * static_cast<double>(num_pairs),
+        benchmark::Counter::kIsRate
+    );
+    state.counters["surviving"] = static_cast<double>(extended_count);
+}
+BENCHMARK(BM_CloneExtenderExtendAll)->Arg(10)->Arg(100)->Arg(1000);
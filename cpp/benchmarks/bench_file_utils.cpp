@@ -0,0 +1,86 @@
+#include <benchmark/benchmark.h>
+#include "utils/file_utils.hpp"
+#include "utils/pattern_set.hpp"
+#include "models/clone_types.hpp"
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace aegis::similarity;
+namespace fs = std::filesystem;
+
+namespace {
+
+// Paths shaped like what discovery actually feeds the matcher: a mix
+// of sources that must pass and dependency/build paths that must hit
+// an exclude pattern
+const std::vector<fs::path>& sample_paths() {
+    static const std::vector<fs::path> paths = {
+        "src/core/detector.py",
+        "src/api/routes.py",
+        "lib/utils/helpers.js",
+        "project/node_modules/lodash/fp/curry.js",
+        "service/__pycache__/models.cpython-312.pyc",
+        "app/venv/lib/python3.12/site-packages/requests/api.py",
+        "build/CMakeFiles/similarity_core.dir/hash_index.cpp.o",
+        "vendor/github.com/pkg/errors/errors.go",
+        "deep/nested/tree/with/many/components/module.py",
+    };
+    return paths;
+}
+
+}  // anonymous namespace
+
+static void BM_MatchesPattern(benchmark::State& state) {
+    const auto& paths = sample_paths();
+
+    for (auto _ : state) {
+        for (const auto& path : paths) {
+            bool matched = FileUtils::matches_pattern(path, "**/node_modules/**");
+            benchmark::DoNotOptimize(matched);
+        }
+    }
+
+    state.counters["paths/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations()) * static_cast<double>(paths.size()),
+        benchmark::Counter::kIsRate
+    );
+}
+BENCHMARK(BM_MatchesPattern);
+
+static void BM_MatchesAnyPatternDefaultExcludes(benchmark::State& state) {
+    const auto& paths = sample_paths();
+    const DetectorConfig config;  // default exclude_patterns
+
+    for (auto _ : state) {
+        for (const auto& path : paths) {
+            bool matched = FileUtils::matches_any_pattern(path, config.exclude_patterns);
+            benchmark::DoNotOptimize(matched);
+        }
+    }
+
+    state.counters["paths/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations()) * static_cast<double>(paths.size()),
+        benchmark::Counter::kIsRate
+    );
+}
+BENCHMARK(BM_MatchesAnyPatternDefaultExcludes);
+
+static void BM_PatternSetDefaultExcludes(benchmark::State& state) {
+    const auto& paths = sample_paths();
+    const DetectorConfig config;
+    const PatternSet set(config.exclude_patterns);  // compiled once
+
+    for (auto _ : state) {
+        for (const auto& path : paths) {
+            bool matched = set.matches(path.generic_string());
+            benchmark::DoNotOptimize(matched);
+        }
+    }
+
+    state.counters["paths/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations()) * static_cast<double>(paths.size()),
+        benchmark::Counter::kIsRate
+    );
+}
+BENCHMARK(BM_PatternSetDefaultExcludes);
@@ -0,0 +1,53 @@
+#include <benchmark/benchmark.h>
+#include "core/rolling_hash.hpp"
+#include <random>
+#include <vector>
+
+using namespace aegis::similarity;
+
+namespace {
+
+std::vector<uint64_t> make_token_hashes(size_t count) {
+    std::mt19937_64 rng(42);
+    std::vector<uint64_t> hashes(count);
+    for (auto& hash : hashes) {
+        hash = rng();
+    }
+    return hashes;
+}
+
+}  // anonymous namespace
+
+static void BM_RollingHashPush(benchmark::State& state) {
+    const auto hashes = make_token_hashes(static_cast<size_t>(state.range(0)));
+    RollingHash hasher(10);
+
+    for (auto _ : state) {
+        hasher.reset();
+        for (const auto hash : hashes) {
+            auto window = hasher.push(hash);
+            benchmark::DoNotOptimize(window);
+        }
+    }
+
+    state.counters["hashes/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations()) * static_cast<double>(hashes.size()),
+        benchmark::Counter::kIsRate
+    );
+}
+BENCHMARK(BM_RollingHashPush)->Arg(1000)->Arg(100000);
+
+static void BM_HashSequenceComputeAll(benchmark::State& state) {
+    const auto hashes = make_token_hashes(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        auto windows = HashSequence::compute_all(hashes, 10);
+        benchmark::DoNotOptimize(windows);
+    }
+
+    state.counters["hashes/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations()) * static_cast<double>(hashes.size()),
+        benchmark::Counter::kIsRate
+    );
+}
+BENCHMARK(BM_HashSequenceComputeAll)->Arg(1000)->Arg(100000);
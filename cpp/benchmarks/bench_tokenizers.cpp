@@ -0,0 +1,104 @@
+#include <benchmark/benchmark.h>
+#include "tokenizers/python_normalizer.hpp"
+#include "tokenizers/js_normalizer.hpp"
+#include "tokenizers/cpp_normalizer.hpp"
+#include <string>
+
+using namespace aegis::similarity;
+
+namespace {
+
+// Representative snippets repeated until the source reaches a realistic
+// file size, so throughput reflects steady-state tokenization
+
+const char* PYTHON_SNIPPET = R"(
+def process_order(order, inventory):
+    """Validate and apply an order against the inventory."""
+    total = 0.0
+    for item in order.items:
+        stock = inventory.get(item.sku)
+        if stock is None or stock.count < item.quantity:
+            raise ValueError(f"out of stock: {item.sku}")
+        total += item.quantity * stock.price
+    return round(total * 1.21, 2)
+)";
+
+const char* JS_SNIPPET = R"(
+function processOrder(order, inventory) {
+    // Validate and apply an order against the inventory
+    let total = 0.0;
+    for (const item of order.items) {
+        const stock = inventory.get(item.sku);
+        if (!stock || stock.count < item.quantity) {
+            throw new Error(`out of stock: ${item.sku}`);
+        }
+        total += item.quantity * stock.price;
+    }
+    return Math.round(total * 1.21 * 100) / 100;
+}
+)";
+
+const char* CPP_SNIPPET = R"(
+double process_order(const Order& order, const Inventory& inventory) {
+    // Validate and apply an order against the inventory
+    double total = 0.0;
+    for (const auto& item : order.items()) {
+        const auto* stock = inventory.find(item.sku);
+        if (stock == nullptr || stock->count < item.quantity) {
+            throw std::runtime_error("out of stock: " + item.sku);
+        }
+        total += static_cast<double>(item.quantity) * stock->price;
+    }
+    return std::round(total * 1.21 * 100.0) / 100.0;
+}
+)";
+
+std::string repeat_snippet(const char* snippet, size_t target_bytes) {
+    std::string source;
+    while (source.size() < target_bytes) {
+        source += snippet;
+    }
+    return source;
+}
+
+void run_tokenizer(benchmark::State& state, TokenNormalizer& normalizer,
+                   const std::string& source) {
+    size_t tokens = 0;
+    for (auto _ : state) {
+        auto result = normalizer.normalize(source);
+        tokens = result.tokens.size();
+        benchmark::DoNotOptimize(result);
+    }
+
+    state.counters["tokens/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations()) * static_cast<double>(tokens),
+        benchmark::Counter::kIsRate
+    );
+    state.SetBytesProcessed(
+        static_cast<int64_t>(state.iterations()) *
+        static_cast<int64_t>(source.size())
+    );
+}
+
+}  // anonymous namespace
+
+static void BM_PythonNormalizer(benchmark::State& state) {
+    const auto source = repeat_snippet(PYTHON_SNIPPET, 64 * 1024);
+    PythonNormalizer normalizer;
+    run_tokenizer(state, normalizer, source);
+}
+BENCHMARK(BM_PythonNormalizer);
+
+static void BM_JavaScriptNormalizer(benchmark::State& state) {
+    const auto source = repeat_snippet(JS_SNIPPET, 64 * 1024);
+    JavaScriptNormalizer normalizer;
+    run_tokenizer(state, normalizer, source);
+}
+BENCHMARK(BM_JavaScriptNormalizer);
+
+static void BM_CppNormalizer(benchmark::State& state) {
+    const auto source = repeat_snippet(CPP_SNIPPET, 64 * 1024);
+    CppNormalizer normalizer;
+    run_tokenizer(state, normalizer, source);
+}
+BENCHMARK(BM_CppNormalizer);
@@ -0,0 +1,258 @@
+// End-to-end performance regression harness.
+//
+// The micro-benchmark suite (similarity_bench) times single functions;
+// this target generates a deterministic synthetic corpus, runs the full
+// SimilarityDetector::analyze() pipeline over it, and gates on
+// throughput floors and a peak-RSS ceiling. Scaling regressions —
+// bucket explosion, allocator churn, accidental quadratic passes — show
+// up here as a throughput drop or an RSS spike long before production
+// corpora hit them.
+//
+// Usage:
+//   similarity_perf [options]
+//     --files <n>              Corpus size in files (default: 200)
+//     --mean-lines <n>         Mean file length; sizes are drawn from a
+//                              heavy-tailed lognormal (default: 120)
+//     --clone-rate <f>         Fraction of files receiving an injected
+//                              clone of a shared snippet (default: 0.3)
+//     --boilerplate <f>        Fraction of lines drawn from a small
+//                              shared pool, driving hot-hash buckets
+//                              (default: 0.1)
+//     --seed <n>               Generator seed (default: 42)
+//     --min-tokens-per-sec <n> Throughput floor (default: 100000; 0 = off)
+//     --min-pairs-per-sec <n>  Matcher floor (default: 0 = off)
+//     --max-rss-mb <n>         Peak-RSS ceiling (default: 2048; 0 = off)
+//     --keep                   Keep the generated corpus on disk
+//
+// Exits non-zero when a floor or ceiling is violated, so a CI job can
+// gate on it directly.
+
+#include "core/similarity_detector.hpp"
+#include <sys/resource.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace aegis::similarity;
+namespace fs = std::filesystem;
+
+namespace {
+
+struct HarnessOptions {
+    size_t files = 200;
+    size_t mean_lines = 120;
+    double clone_rate = 0.3;
+    double boilerplate = 0.1;
+    uint64_t seed = 42;
+    double min_tokens_per_sec = 100000.0;
+    double min_pairs_per_sec = 0.0;
+    size_t max_rss_mb = 2048;
+    bool keep = false;
+};
+
+// Snippets injected as clones: long enough that every injection clears
+// the default min_clone_tokens and produces real pairs
+const char* const CLONE_SNIPPETS[] = {
+    "def compute_totals(entries):\n"
+    "    total = 0\n"
+    "    for entry in entries:\n"
+    "        if entry.amount > 0:\n"
+    "            total += entry.amount * entry.rate\n"
+    "        else:\n"
+    "            total -= entry.penalty\n"
+    "    return total / max(len(entries), 1)\n",
+
+    "def validate_payload(payload):\n"
+    "    errors = []\n"
+    "    for field in payload.required:\n"
+    "        if field not in payload.data:\n"
+    "            errors.append(field)\n"
+    "        elif payload.data[field] is None:\n"
+    "            errors.append(field)\n"
+    "    return errors\n",
+};
+
+// Boilerplate line pool: a handful of lines repeated across the whole
+// corpus, so their windows pile into a few very hot hash buckets
+const char* const BOILERPLATE_LINES[] = {
+    "import os",
+    "import sys",
+    "import json",
+    "logger = logging.getLogger(__name__)",
+    "if __name__ == '__main__':",
+};
+
+/**
+ * Write a deterministic synthetic corpus under `root`.
+ *
+ * File lengths follow a lognormal around mean_lines, reproducing the
+ * heavy-tailed skew of real trees (many small files, a few huge ones).
+ * Returns the number of lines written.
+ */
+size_t generate_corpus(const fs::path& root, const HarnessOptions& opt) {
+    std::mt19937_64 rng(opt.seed);
+
+    // lognormal(mu, 0.8) has mean exp(mu + 0.32); solve mu for the
+    // requested mean so --mean-lines behaves intuitively
+    const double mu = std::log(static_cast<double>(opt.mean_lines)) - 0.32;
+    std::lognormal_distribution<double> length_dist(mu, 0.8);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::uniform_int_distribution<size_t> boilerplate_pick(
+        0, std::size(BOILERPLATE_LINES) - 1);
+    std::uniform_int_distribution<size_t> snippet_pick(
+        0, std::size(CLONE_SNIPPETS) - 1);
+
+    size_t total_lines = 0;
+    for (size_t f = 0; f < opt.files; ++f) {
+        const auto lines =
+            static_cast<size_t>(std::max(10.0, length_dist(rng)));
+
+        std::ostringstream body;
+        if (unit(rng) < opt.clone_rate) {
+            body << CLONE_SNIPPETS[snippet_pick(rng)] << "\n";
+        }
+        for (size_t i = 0; i < lines; ++i) {
+            if (unit(rng) < opt.boilerplate) {
+                body << BOILERPLATE_LINES[boilerplate_pick(rng)] << "\n";
+            } else {
+                // Unique assignment so ordinary lines never collide
+                body << "value_" << f << "_" << i << " = compute_"
+                     << (rng() % 1000) << "(" << i << ")\n";
+            }
+            ++total_lines;
+        }
+
+        std::ofstream out(root / ("gen_" + std::to_string(f) + ".py"));
+        out << body.str();
+    }
+    return total_lines;
+}
+
+size_t peak_rss_mb() {
+    struct rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<size_t>(usage.ru_maxrss) / 1024;  // KB -> MB on Linux
+}
+
+bool parse_args(int argc, char* argv[], HarnessOptions& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const auto next = [&]() -> const char* {
+            return i + 1 < argc ? argv[++i] : nullptr;
+        };
+
+        if (arg == "--files") {
+            if (const auto* v = next()) opt.files = std::stoul(v);
+        } else if (arg == "--mean-lines") {
+            if (const auto* v = next()) opt.mean_lines = std::stoul(v);
+        } else if (arg == "--clone-rate") {
+            if (const auto* v = next()) opt.clone_rate = std::stod(v);
+        } else if (arg == "--boilerplate") {
+            if (const auto* v = next()) opt.boilerplate = std::stod(v);
+        } else if (arg == "--seed") {
+            if (const auto* v = next()) opt.seed = std::stoull(v);
+        } else if (arg == "--min-tokens-per-sec") {
+            if (const auto* v = next()) opt.min_tokens_per_sec = std::stod(v);
+        } else if (arg == "--min-pairs-per-sec") {
+            if (const auto* v = next()) opt.min_pairs_per_sec = std::stod(v);
+        } else if (arg == "--max-rss-mb") {
+            if (const auto* v = next()) opt.max_rss_mb = std::stoul(v);
+        } else if (arg == "--keep") {
+            opt.keep = true;
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    HarnessOptions opt;
+    if (!parse_args(argc, argv, opt)) {
+        return 2;
+    }
+
+    const auto corpus = fs::temp_directory_path() /
+        ("aegis_perf_" + std::to_string(opt.seed));
+    fs::remove_all(corpus);
+    fs::create_directories(corpus);
+
+    std::cerr << "Generating " << opt.files << " files (seed " << opt.seed
+              << ", clone rate " << opt.clone_rate << ", boilerplate "
+              << opt.boilerplate << ")..." << std::endl;
+    const size_t corpus_lines = generate_corpus(corpus, opt);
+
+    DetectorConfig config;
+    config.extensions = {".py"};
+
+    SimilarityDetector detector(config);
+    const auto start = std::chrono::steady_clock::now();
+    const auto report = detector.analyze(corpus);
+    const auto wall = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    if (!opt.keep) {
+        fs::remove_all(corpus);
+    }
+
+    const double seconds = std::max(static_cast<double>(wall), 1.0) / 1000.0;
+    const double tokens_per_sec =
+        static_cast<double>(report.performance.total_tokens) / seconds;
+    const double pairs_per_sec =
+        static_cast<double>(report.performance.candidate_pairs) / seconds;
+    const size_t rss_mb = peak_rss_mb();
+
+    // Phase breakdown straight from the report's TimingInfo, plus the
+    // derived rates and RSS, as one JSON document for trend tooling
+    nlohmann::json out = {
+        {"corpus", {
+            {"files", opt.files},
+            {"lines", corpus_lines},
+            {"seed", opt.seed},
+            {"clone_rate", opt.clone_rate},
+            {"boilerplate", opt.boilerplate}
+        }},
+        {"timing", report.timing.to_json()},
+        {"throughput", {
+            {"tokens_per_sec", tokens_per_sec},
+            {"candidate_pairs_per_sec", pairs_per_sec},
+            {"wall_ms", wall}
+        }},
+        {"clone_pairs_found", report.summary.clone_pairs_found},
+        {"peak_rss_mb", rss_mb}
+    };
+    std::cout << out.dump(2) << std::endl;
+
+    // Gates: any violation fails the run so CI can block the change
+    bool failed = false;
+    if (opt.min_tokens_per_sec > 0 && tokens_per_sec < opt.min_tokens_per_sec) {
+        std::cerr << "FAIL: tokens/sec " << tokens_per_sec
+                  << " below floor " << opt.min_tokens_per_sec << std::endl;
+        failed = true;
+    }
+    if (opt.min_pairs_per_sec > 0 && pairs_per_sec < opt.min_pairs_per_sec) {
+        std::cerr << "FAIL: candidate pairs/sec " << pairs_per_sec
+                  << " below floor " << opt.min_pairs_per_sec << std::endl;
+        failed = true;
+    }
+    if (opt.max_rss_mb > 0 && rss_mb > opt.max_rss_mb) {
+        std::cerr << "FAIL: peak RSS " << rss_mb << " MB above ceiling "
+                  << opt.max_rss_mb << " MB" << std::endl;
+        failed = true;
+    }
+
+    if (report.summary.clone_pairs_found == 0 && opt.clone_rate > 0) {
+        std::cerr << "FAIL: injected clones were not detected" << std::endl;
+        failed = true;
+    }
+
+    return failed ? 1 : 0;
+}
@@ -1,7 +1,9 @@
 #include "core/clone_extender.hpp"
 #include "core/hash_index.hpp"
 #include <algorithm>
-#include <unordered_set>
+#include <array>
+#include <cmath>
+#include <set>
 
 namespace aegis::similarity {
 
@@ -20,35 +22,45 @@ float CloneExtender::jaccard_similarity(
         return 0.0f;
     }
 
-    // Build hash sets for both sequences (using normalized hashes)
-    std::unordered_multiset<uint32_t> set_a;
-    std::unordered_multiset<uint32_t> set_b;
-
     const size_t end_a = std::min(start_a + count_a, tokens_a.size());
     const size_t end_b = std::min(start_b + count_b, tokens_b.size());
 
+    // Sorted-array kernel: copy the region hashes into thread-local
+    // scratch, sort, and intersect with a linear merge. No hashing and
+    // no heap traffic in the innermost Type-3 loop (the scratch buffers
+    // reach steady-state capacity after a few calls).
+    static thread_local std::vector<uint32_t> sorted_a;
+    static thread_local std::vector<uint32_t> sorted_b;
+
+    sorted_a.clear();
+    sorted_b.clear();
     for (size_t i = start_a; i < end_a; ++i) {
-        set_a.insert(tokens_a[i].normalized_hash);
+        sorted_a.push_back(tokens_a[i].normalized_hash);
     }
     for (size_t i = start_b; i < end_b; ++i) {
-        set_b.insert(tokens_b[i].normalized_hash);
+        sorted_b.push_back(tokens_b[i].normalized_hash);
     }
+    std::sort(sorted_a.begin(), sorted_a.end());
+    std::sort(sorted_b.begin(), sorted_b.end());
 
-    // Calculate intersection size
+    // Multiset intersection: each duplicate matches at most once
     size_t intersection = 0;
-    for (const auto& hash : set_a) {
-        if (set_b.contains(hash)) {
-            const size_t count = std::min(set_a.count(hash), set_b.count(hash));
-            intersection += count;
-            // Avoid counting the same element multiple times
-            while (set_b.contains(hash)) {
-                set_b.erase(set_b.find(hash));
-            }
+    size_t i = 0;
+    size_t j = 0;
+    while (i < sorted_a.size() && j < sorted_b.size()) {
+        if (sorted_a[i] < sorted_b[j]) {
+            ++i;
+        } else if (sorted_b[j] < sorted_a[i]) {
+            ++j;
+        } else {
+            ++intersection;
+            ++i;
+            ++j;
         }
     }
 
     // Union = |A| + |B| - intersection
-    const size_t union_size = (end_a - start_a) + (end_b - start_b) - intersection;
+    const size_t union_size = sorted_a.size() + sorted_b.size() - intersection;
 
     if (union_size == 0) {
         return 0.0f;
@@ -62,7 +74,8 @@ float CloneExtender::alignment_similarity(
     const size_t start_a, const size_t count_a,
     const std::vector<NormalizedToken>& tokens_b,
     const size_t start_b, const size_t count_b,
-    const size_t max_gap
+    const size_t max_gap,
+    const float early_exit_below
 ) {
     if (count_a == 0 || count_b == 0) {
         return 0.0f;
@@ -70,6 +83,14 @@ float CloneExtender::alignment_similarity(
 
     const size_t end_a = std::min(start_a + count_a, tokens_a.size());
     const size_t end_b = std::min(start_b + count_b, tokens_b.size());
+    const size_t total = std::max(count_a, count_b);
+
+    // Minimum matches needed to reach the caller's threshold. ceil()
+    // keeps exact-threshold scores alive; 0 disables the bail-out.
+    const size_t needed = early_exit_below > 0.0f
+        ? static_cast<size_t>(
+              std::ceil(early_exit_below * static_cast<float>(total)))
+        : 0;
 
     size_t matches = 0;
     size_t pos_a = start_a;
@@ -80,6 +101,19 @@ float CloneExtender::alignment_similarity(
             ++matches;
             ++pos_a;
             ++pos_b;
+
+            // Matched-run fast path: aligned clone regions are mostly
+            // long runs of equal hashes, so chew them four at a time
+            // before dropping back to the per-token gap logic
+            while (pos_a + 4 <= end_a && pos_b + 4 <= end_b &&
+                   tokens_a[pos_a].normalized_hash == tokens_b[pos_b].normalized_hash &&
+                   tokens_a[pos_a + 1].normalized_hash == tokens_b[pos_b + 1].normalized_hash &&
+                   tokens_a[pos_a + 2].normalized_hash == tokens_b[pos_b + 2].normalized_hash &&
+                   tokens_a[pos_a + 3].normalized_hash == tokens_b[pos_b + 3].normalized_hash) {
+                matches += 4;
+                pos_a += 4;
+                pos_b += 4;
+            }
         } else {
             // Try to find a match within max_gap
             bool found = false;
@@ -108,10 +142,22 @@ float CloneExtender::alignment_similarity(
                 ++pos_a;
                 ++pos_b;
             }
+
+            // Mismatch budget: if matching every remaining token can no
+            // longer reach the threshold, the caller will reject this
+            // score whatever it is — stop scanning and report the
+            // (below-threshold) upper bound
+            if (needed > 0) {
+                const size_t best_possible =
+                    matches + std::min(end_a - pos_a, end_b - pos_b);
+                if (best_possible < needed) {
+                    return static_cast<float>(best_possible)
+                         / static_cast<float>(total);
+                }
+            }
         }
     }
 
-    const size_t total = std::max(count_a, count_b);
     return static_cast<float>(matches) / static_cast<float>(total);
 }
 
@@ -223,11 +269,14 @@ ClonePair CloneExtender::extend(
     end_a += fwd_ext;
     end_b += fwd_ext;
 
-    // Calculate new similarity
+    // Calculate new similarity; the kernel may bail out early once the
+    // score provably cannot reach min_similarity (the rejection below
+    // fires either way)
     const float sim = alignment_similarity(
         tokens_a, start_a, end_a - start_a,
         tokens_b, start_b, end_b - start_b,
-        config_.max_gap
+        config_.max_gap,
+        config_.min_similarity
     );
 
     // Only accept extension if similarity is above a threshold
@@ -276,6 +325,57 @@ ClonePair CloneExtender::extend(
     return extended;
 }
 
+std::optional<ClonePair> CloneExtender::extend_one(
+    const ClonePair& pair,
+    const std::unordered_map<std::string, const TokenizedFile*>& file_map,
+    const HashIndex& index
+) const {
+    // Get files for this pair
+    const std::string& path_a = index.get_file_path(pair.location_a.file_id);
+    const std::string& path_b = index.get_file_path(pair.location_b.file_id);
+
+    auto it_a = file_map.find(path_a);
+    auto it_b = file_map.find(path_b);
+
+    if (it_a == file_map.end() || it_b == file_map.end()) {
+        return pair;  // Can't extend, keep original
+    }
+
+    ClonePair extended = extend(pair, *it_a->second, *it_b->second);
+
+    // Only keep if meets minimum size
+    if (extended.token_count() >= config_.min_tokens) {
+        return extended;
+    }
+    return std::nullopt;
+}
+
+std::vector<ClonePair> CloneExtender::deduplicate(std::vector<ClonePair> pairs) {
+    // Different seeds frequently extend to the same region; keep the
+    // first occurrence of each exact (location_a, location_b) region
+    auto region_key = [](const ClonePair& pair) {
+        return std::array<uint32_t, 6>{
+            pair.location_a.file_id,
+            pair.location_a.token_start,
+            pair.location_a.token_count,
+            pair.location_b.file_id,
+            pair.location_b.token_start,
+            pair.location_b.token_count
+        };
+    };
+
+    std::set<std::array<uint32_t, 6>> seen;
+    std::vector<ClonePair> unique;
+    unique.reserve(pairs.size());
+
+    for (auto& pair : pairs) {
+        if (seen.insert(region_key(pair)).second) {
+            unique.push_back(std::move(pair));
+        }
+    }
+    return unique;
+}
+
 std::vector<ClonePair> CloneExtender::extend_all(
     const std::vector<ClonePair>& pairs,
     const std::vector<TokenizedFile>& files,
@@ -291,27 +391,48 @@ std::vector<ClonePair> CloneExtender::extend_all(
     }
 
     for (const auto& pair : pairs) {
-        // Get files for this pair
-        const std::string& path_a = index.get_file_path(pair.location_a.file_id);
-        const std::string& path_b = index.get_file_path(pair.location_b.file_id);
+        if (auto extended = extend_one(pair, file_map, index)) {
+            extended_pairs.push_back(std::move(*extended));
+        }
+    }
 
-        auto it_a = file_map.find(path_a);
-        auto it_b = file_map.find(path_b);
+    return deduplicate(std::move(extended_pairs));
+}
 
-        if (it_a == file_map.end() || it_b == file_map.end()) {
-            extended_pairs.push_back(pair);  // Can't extend, keep original
-            continue;
-        }
+std::vector<ClonePair> CloneExtender::extend_all(
+    const std::vector<ClonePair>& pairs,
+    const std::vector<TokenizedFile>& files,
+    const HashIndex& index,
+    ThreadPool& pool
+) const {
+    // Small batches aren't worth the scheduling overhead
+    if (pairs.size() < 64 || pool.size() <= 1) {
+        return extend_all(pairs, files, index);
+    }
 
-        ClonePair extended = extend(pair, *it_a->second, *it_b->second);
+    // Build file lookup (shared read-only across workers)
+    std::unordered_map<std::string, const TokenizedFile*> file_map;
+    for (const auto& file : files) {
+        file_map[file.path] = &file;
+    }
+
+    // One result slot per input pair: no contention on the hot path and
+    // output order stays identical to the sequential version
+    std::vector<std::optional<ClonePair>> slots(pairs.size());
+
+    pool.parallel_for(0, pairs.size(), [&](size_t i) {
+        slots[i] = extend_one(pairs[i], file_map, index);
+    });
 
-        // Only keep if meets minimum size
-        if (extended.token_count() >= config_.min_tokens) {
-            extended_pairs.push_back(extended);
+    std::vector<ClonePair> extended_pairs;
+    extended_pairs.reserve(pairs.size());
+    for (auto& slot : slots) {
+        if (slot) {
+            extended_pairs.push_back(std::move(*slot));
         }
     }
 
-    return extended_pairs;
+    return deduplicate(std::move(extended_pairs));
 }
 
 }  // namespace aegis::similarity
@@ -2,6 +2,8 @@
 
 #include "models/clone_types.hpp"
 #include "core/hash_index.hpp"
+#include <optional>
+#include <unordered_map>
 #include <vector>
 
 
@@ -86,8 +88,20 @@ public:
      * Calculate token-level alignment similarity.
      *
      * Compares tokens position-by-position, accounting for gaps.
-     * More precise than Jaccard for structured code.
+     * More precise than Jaccard for structured code. The scan is
+     * banded: the two cursors advance in lockstep and may only slip by
+     * max_gap per resync, so cost stays linear in the region length.
      *
+     * When early_exit_below is set, the kernel stops scoring as soon as
+     * matching every remaining token could no longer reach that
+     * threshold. Extension re-scores thousands of low-similarity
+     * candidates per region, so bailing out early is the common case
+     * there. On a bail-out the returned score is an upper bound that is
+     * provably below the threshold; scores at or above the threshold
+     * are always exact.
+     *
+     * @param early_exit_below Bail-out threshold (0 = always score
+     *        the full region)
      * @return Similarity score 0.0 to 1.0
      */
     static float alignment_similarity(
@@ -95,7 +109,8 @@ public:
         size_t start_a, size_t count_a,
         const std::vector<NormalizedToken>& tokens_b,
         size_t start_b, size_t count_b,
-        size_t max_gap = 5
+        size_t max_gap = 5,
+        float early_exit_below = 0.0f
     );
 
     /**
@@ -112,9 +127,42 @@ public:
         const HashIndex& index
     ) const;
 
+    /**
+     * Parallel variant: shards the pair list across the thread pool.
+     *
+     * Pairs are independent given read-only access to the tokenized
+     * files, so each is extended into its own result slot; output order
+     * and contents match the sequential version. Falls back to the
+     * sequential path for small batches or a single-thread pool.
+     */
+    [[nodiscard]] std::vector<ClonePair> extend_all(
+        const std::vector<ClonePair>& pairs,
+        const std::vector<TokenizedFile>& files,
+        const HashIndex& index,
+        ThreadPool& pool
+    ) const;
+
 private:
     Config config_;
 
+    /**
+     * Extend one pair against the file lookup map. Returns nullopt if
+     * the extended region falls below the minimum token count.
+     */
+    [[nodiscard]] std::optional<ClonePair> extend_one(
+        const ClonePair& pair,
+        const std::unordered_map<std::string, const TokenizedFile*>& file_map,
+        const HashIndex& index
+    ) const;
+
+    /**
+     * Drop pairs whose extended regions are identical — different seeds
+     * frequently converge on the same region. Keeps first occurrence.
+     */
+    [[nodiscard]] static std::vector<ClonePair> deduplicate(
+        std::vector<ClonePair> pairs
+    );
+
     // Extend forward from the current position
     [[nodiscard]] size_t extend_forward(
         const std::vector<NormalizedToken>& tokens_a, size_t pos_a,
@@ -0,0 +1,62 @@
+#include "core/federated_index.hpp"
+#include "core/index_store.hpp"
+#include <algorithm>
+#include <ranges>
+
+namespace aegis::similarity {
+
+FederatedIndex::FederatedIndex(Config config)
+    : config_(config)
+{
+}
+
+bool FederatedIndex::add_artifact(const std::filesystem::path& store_file) {
+    IndexStore store;
+    if (!store.load(store_file)) {
+        return false;
+    }
+
+    ArtifactInfo info;
+    info.source = store_file.string();
+    info.location_count = store.index.location_count();
+
+    // merge_from() re-registers the artifact's files and remaps its
+    // location file_ids into the combined namespace
+    const size_t before = index_.file_count();
+    index_.merge_from(std::move(store.index));
+    const size_t after = index_.file_count();
+
+    // Ids registered by this merge belong to this artifact; ids that
+    // already existed keep their original owner
+    const auto artifact_id = static_cast<uint32_t>(artifacts_.size());
+    artifact_of_.resize(after, artifact_id);
+
+    info.file_count = after - before;
+    artifacts_.push_back(std::move(info));
+    return true;
+}
+
+std::vector<ClonePair> FederatedIndex::find_cross_clones(ThreadPool* pool) {
+    index_.set_max_locations_per_hash(config_.max_locations_per_hash);
+    index_.set_pair_groups(artifact_of_);
+
+    std::vector<ClonePair> pairs = pool
+        ? index_.find_clone_pairs_parallel(*pool, 1, config_.similarity_threshold)
+        : index_.find_clone_pairs(1, config_.similarity_threshold);
+
+    // Leave the index unrestricted for any direct queries afterwards
+    index_.set_pair_groups({});
+
+    pairs = HashIndex::consolidate_overlaps(std::move(pairs));
+    pairs = HashIndex::merge_adjacent_clones(pairs, config_.max_gap_tokens);
+    pairs = HashIndex::filter_by_size(pairs, config_.min_clone_tokens);
+
+    // Largest first, matching the detector's report ordering
+    std::ranges::sort(pairs, [](const auto& a, const auto& b) {
+        return a.token_count() > b.token_count();
+    });
+
+    return pairs;
+}
+
+}  // namespace aegis::similarity
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "core/hash_index.hpp"
+#include "utils/thread_pool.hpp"
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace aegis::similarity {
+
+/**
+ * Federation query configuration.
+ */
+struct FederatedConfig {
+    // Same roles as their DetectorConfig counterparts
+    size_t min_clone_tokens = 30;
+    float similarity_threshold = 0.7f;
+    size_t max_locations_per_hash = HashIndex::DEFAULT_MAX_LOCATIONS_PER_HASH;
+    size_t max_gap_tokens = 5;
+};
+
+/**
+ * Cross-repository clone analysis over independently built indexes.
+ *
+ * Each artifact is an IndexStore file written by one repository's own
+ * analysis (incremental mode or the server's save_snapshot), so
+ * federation is an O(changed repo) operation: a repo re-exports its
+ * artifact when it changes, and the merge only ever loads finished
+ * index images.
+ *
+ * add_artifact() absorbs a store into one combined index — merge_from()
+ * remaps each artifact's file_id namespace — while remembering which
+ * artifact every file came from. Queries then restrict pair generation
+ * to cross-artifact pairs (see HashIndex::set_pair_groups): intra-repo
+ * clones are already known to each repo's own report, and most
+ * boilerplate repeats within a repo, so the restriction prunes the bulk
+ * of the candidate space before it is ever materialized.
+ */
+class FederatedIndex {
+public:
+    using Config = FederatedConfig;
+
+    struct ArtifactInfo {
+        std::string source;         // Store file the artifact came from
+        size_t file_count = 0;      // Files this artifact contributed
+        size_t location_count = 0;  // Locations it brought into the merge
+    };
+
+    explicit FederatedIndex(Config config = {});
+
+    /**
+     * Load an IndexStore artifact and merge it into the combined index.
+     * Returns false (and merges nothing) if the file can't be loaded.
+     * A path already contributed by an earlier artifact keeps its
+     * original owner.
+     */
+    bool add_artifact(const std::filesystem::path& store_file);
+
+    size_t artifact_count() const { return artifacts_.size(); }
+    const std::vector<ArtifactInfo>& artifacts() const { return artifacts_; }
+
+    /**
+     * The combined index; get_file_path() resolves the file_ids in
+     * pairs returned by find_cross_clones().
+     */
+    const HashIndex& index() const { return index_; }
+
+    /**
+     * Index of the artifact that contributed a file.
+     */
+    uint32_t artifact_of(uint32_t file_id) const {
+        return file_id < artifact_of_.size() ? artifact_of_[file_id] : 0;
+    }
+
+    /**
+     * Find clones whose two sides come from different artifacts.
+     *
+     * Raw pairs go through the same consolidate / adjacent-merge /
+     * size-filter pipeline as the detector's own matching and come back
+     * sorted largest-first, so callers can report them directly.
+     *
+     * @param pool Optional pool for parallel pair finding
+     */
+    std::vector<ClonePair> find_cross_clones(ThreadPool* pool = nullptr);
+
+private:
+    Config config_;
+    HashIndex index_;
+    std::vector<ArtifactInfo> artifacts_;
+
+    // file_id in the combined index -> index into artifacts_
+    std::vector<uint32_t> artifact_of_;
+};
+
+}  // namespace aegis::similarity
@@ -1,122 +1,532 @@
 #include "core/hash_index.hpp"
+#include "core/minhash.hpp"
 #include "core/rolling_hash.hpp"
+#include "utils/metrics.hpp"
 #include <algorithm>
+#include <istream>
+#include <limits>
 #include <mutex>
+#include <ostream>
 #include <ranges>
 
 namespace aegis::similarity {
 
+namespace {
+
+// Rolling hashes are values mod 1e9+9, so their high bits carry little
+// entropy. Finalize them through a splitmix64-style mixer before using
+// them as open-addressing probe positions.
+uint64_t mix_hash(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+}  // anonymous namespace
+
 void HashIndex::clear() {
-    index_.clear();
+    entries_.clear();
+    buckets_.clear();
+    locations_.clear();
+    unique_hashes_ = 0;
+    dirty_ = false;
     file_paths_.clear();
-    path_to_id_.clear();
+    pair_groups_.clear();
 }
 
-uint32_t HashIndex::register_file(const std::string& path) {
-    auto it = path_to_id_.find(path);
-    if (it != path_to_id_.end()) {
-        return it->second;
-    }
+void HashIndex::clear_locations() {
+    entries_.clear();
+    entries_.shrink_to_fit();  // The point is releasing the memory
+    buckets_.clear();
+    buckets_.shrink_to_fit();
+    locations_.clear();
+    locations_.shrink_to_fit();
+    unique_hashes_ = 0;
+    dirty_ = false;
+}
 
-    const auto id = static_cast<uint32_t>(file_paths_.size());
-    file_paths_.push_back(path);
-    path_to_id_[path] = id;
-    return id;
+uint32_t HashIndex::register_file(const std::string_view path) {
+    return file_paths_.intern(path);
 }
 
 const std::string& HashIndex::get_file_path(uint32_t file_id) const {
-    static const std::string empty;
-    if (file_id >= file_paths_.size()) {
-        return empty;
-    }
-    return file_paths_[file_id];
+    return file_paths_.at(file_id);
 }
 
 void HashIndex::add_hash(const uint64_t hash, const HashLocation& location) {
-    index_[hash].push_back(location);
+    entries_.emplace_back(hash, location);
+    dirty_ = true;
+}
+
+void HashIndex::add_hashes(
+    const std::span<const uint64_t> hashes,
+    const std::span<const HashLocation> locations
+) {
+    entries_.reserve(entries_.size() + hashes.size());
+    for (size_t i = 0; i < hashes.size(); ++i) {
+        entries_.emplace_back(hashes[i], locations[i]);
+    }
+    if (!hashes.empty()) {
+        dirty_ = true;
+    }
+}
+
+void HashIndex::reserve(const size_t additional) {
+    entries_.reserve(entries_.size() + additional);
+}
+
+void HashIndex::ensure_frozen() const {
+    if (!dirty_) {
+        return;
+    }
+
+    unique_hashes_ = 0;
+    locations_.clear();
+    buckets_.clear();
+
+    if (entries_.empty()) {
+        dirty_ = false;
+        return;
+    }
+
+    // Size the table for a load factor below 0.5
+    size_t capacity = 16;
+    while (capacity < entries_.size() * 2) {
+        capacity *= 2;
+    }
+    buckets_.resize(capacity);
+    const size_t mask = capacity - 1;
+
+    // Pass 1: count locations per hash (linear probing; an upper bound on
+    // slots is guaranteed since capacity > entry count)
+    for (const auto& [hash, loc] : entries_) {
+        size_t slot = mix_hash(hash) & mask;
+        while (buckets_[slot].count != 0 && buckets_[slot].hash != hash) {
+            slot = (slot + 1) & mask;
+        }
+        if (buckets_[slot].count == 0) {
+            buckets_[slot].hash = hash;
+            ++unique_hashes_;
+        }
+        ++buckets_[slot].count;
+    }
+
+    // Convert counts into arena offsets (exclusive prefix sum)
+    uint32_t offset = 0;
+    for (auto& bucket : buckets_) {
+        if (bucket.count == 0) continue;
+        bucket.offset = offset;
+        offset += bucket.count;
+        bucket.count = 0;  // Reused as a fill cursor in pass 2
+    }
+
+    // Pass 2: scatter locations into their contiguous groups. The probe
+    // sequence is identical to pass 1, so the first slot holding our hash
+    // along the chain is the bucket pass 1 created for it.
+    locations_.resize(entries_.size());
+    for (const auto& [hash, loc] : entries_) {
+        size_t slot = mix_hash(hash) & mask;
+        while (buckets_[slot].hash != hash) {
+            slot = (slot + 1) & mask;
+        }
+        auto& bucket = buckets_[slot];
+        locations_[bucket.offset + bucket.count] = loc;
+        ++bucket.count;
+    }
+
+    dirty_ = false;
 }
 
-const std::vector<HashLocation>* HashIndex::get_locations(const uint64_t hash) const {
-    auto it = index_.find(hash);
-    if (it == index_.end()) {
+const HashIndex::Bucket* HashIndex::find_bucket(const uint64_t hash) const {
+    if (buckets_.empty()) {
         return nullptr;
     }
-    return &it->second;
+    const size_t mask = buckets_.size() - 1;
+    size_t slot = mix_hash(hash) & mask;
+    while (buckets_[slot].count != 0) {
+        if (buckets_[slot].hash == hash) {
+            return &buckets_[slot];
+        }
+        slot = (slot + 1) & mask;
+    }
+    return nullptr;
 }
 
-size_t HashIndex::location_count() const {
-    size_t count = 0;
-    for (const auto& locations : index_ | std::views::values) {
-        count += locations.size();
+LocationSpan HashIndex::get_locations(const uint64_t hash) const {
+    ensure_frozen();
+    const Bucket* bucket = find_bucket(hash);
+    if (bucket == nullptr) {
+        return {};
     }
-    return count;
+    return {locations_.data() + bucket->offset, bucket->count};
 }
 
-std::vector<ClonePair> HashIndex::find_clone_pairs([[maybe_unused]] size_t min_matches) const {
-    std::vector<ClonePair> results;
+void HashIndex::merge_from(HashIndex&& other) {
+    // Translate shard-local file ids into this index's registry
+    std::vector<uint32_t> id_map;
+    id_map.reserve(other.file_paths_.size());
+    for (uint32_t id = 0; id < other.file_paths_.size(); ++id) {
+        id_map.push_back(register_file(other.file_paths_.at(id)));
+    }
 
-    // Limit to prevent combinatorial explosion (N locations = N*(N-1)/2 pairs)
-    // 500 locations = 124,750 pairs which is manageable
-    // 5000 locations = 12.5M pairs which causes OOM
+    entries_.reserve(entries_.size() + other.entries_.size());
+    for (auto& [hash, loc] : other.entries_) {
+        loc.file_id = id_map[loc.file_id];
+        entries_.emplace_back(hash, loc);
+    }
+    dirty_ = true;
 
-    for (const auto& [hash, locations] : index_) {
-        // Skip hashes that don't appear multiple times
-        if (locations.size() < 2) {
-            continue;
+    other.clear();
+}
+
+void HashIndex::remove_file(const uint32_t file_id) {
+    std::erase_if(entries_, [file_id](const auto& entry) {
+        return entry.second.file_id == file_id;
+    });
+    dirty_ = true;
+}
+
+namespace {
+
+// Binary format markers for save()/load()
+constexpr uint32_t INDEX_MAGIC = 0x41454758;  // "AEGX"
+constexpr uint32_t INDEX_VERSION = 3;  // v3: flat image of the frozen tables
+
+template<typename T>
+void write_pod(std::ostream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+bool read_pod(std::istream& in, T& value) {
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return in.good();
+}
+
+void write_string(std::ostream& out, const std::string& str) {
+    write_pod(out, static_cast<uint32_t>(str.size()));
+    out.write(str.data(), static_cast<std::streamsize>(str.size()));
+}
+
+bool read_string(std::istream& in, std::string& str) {
+    uint32_t size = 0;
+    if (!read_pod(in, size)) return false;
+    str.resize(size);
+    in.read(str.data(), size);
+    return in.good();
+}
+
+}  // anonymous namespace
+
+bool HashIndex::save(std::ostream& out) const {
+    // The image is the frozen form dumped as-is: the full open-addressing
+    // bucket table (empty slots included) followed by the location arena,
+    // so load() is two bulk reads with no re-hashing. All offsets in the
+    // image are table-relative, keeping the layout relocatable.
+    ensure_frozen();
+
+    write_pod(out, INDEX_MAGIC);
+    write_pod(out, INDEX_VERSION);
+
+    write_pod(out, static_cast<uint64_t>(file_paths_.size()));
+    write_pod(out, static_cast<uint64_t>(buckets_.size()));
+    write_pod(out, static_cast<uint64_t>(locations_.size()));
+    write_pod(out, static_cast<uint64_t>(unique_hashes_));
+
+    // File registry
+    for (uint32_t id = 0; id < file_paths_.size(); ++id) {
+        write_string(out, file_paths_.at(id));
+    }
+
+    // Frozen tables, one write each
+    out.write(
+        reinterpret_cast<const char*>(buckets_.data()),
+        static_cast<std::streamsize>(buckets_.size() * sizeof(Bucket))
+    );
+    out.write(
+        reinterpret_cast<const char*>(locations_.data()),
+        static_cast<std::streamsize>(locations_.size() * sizeof(HashLocation))
+    );
+
+    return out.good();
+}
+
+bool HashIndex::load(std::istream& in) {
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    if (!read_pod(in, magic) || magic != INDEX_MAGIC) return false;
+    if (!read_pod(in, version) || version != INDEX_VERSION) return false;
+
+    clear();
+
+    uint64_t file_count = 0;
+    uint64_t bucket_count = 0;
+    uint64_t location_count = 0;
+    uint64_t unique_hashes = 0;
+    if (!read_pod(in, file_count) || !read_pod(in, bucket_count) ||
+        !read_pod(in, location_count) || !read_pod(in, unique_hashes)) {
+        return false;
+    }
+    // The bucket table is a power of two (or empty for an empty index)
+    if (bucket_count != 0 && (bucket_count & (bucket_count - 1)) != 0) {
+        return false;
+    }
+
+    // File registry
+    for (uint64_t i = 0; i < file_count; ++i) {
+        std::string path;
+        if (!read_string(in, path)) {
+            clear();
+            return false;
         }
+        file_paths_.intern(path);
+    }
 
-        // Skip overly common hashes (likely trivial patterns like 'return', 'if', etc.)
-        // These cause O(N^2) explosion and aren't useful for clone detection
-        if (constexpr size_t MAX_LOCATIONS_PER_HASH = 500; locations.size() > MAX_LOCATIONS_PER_HASH) {
-            continue;
+    // Frozen tables land directly in query-ready form: two bulk reads
+    // instead of one stream read per location
+    buckets_.resize(bucket_count);
+    in.read(
+        reinterpret_cast<char*>(buckets_.data()),
+        static_cast<std::streamsize>(bucket_count * sizeof(Bucket))
+    );
+    if (!in.good()) {
+        clear();
+        return false;
+    }
+    locations_.resize(location_count);
+    in.read(
+        reinterpret_cast<char*>(locations_.data()),
+        static_cast<std::streamsize>(location_count * sizeof(HashLocation))
+    );
+    if (!in.good()) {
+        clear();
+        return false;
+    }
+    unique_hashes_ = unique_hashes;
+
+    // Offsets and counts arrive raw from the image; validate every
+    // bucket's range before it indexes locations_, since load_snapshot
+    // feeds arbitrary files here and a corrupt image must be rejected,
+    // not read out of bounds
+    for (const auto& bucket : buckets_) {
+        if (bucket.count > location_count ||
+            bucket.offset > location_count - bucket.count) {
+            clear();
+            return false;
+        }
+    }
+
+    // Rebuild the ingest log from the image (memory-speed, no I/O) so
+    // later mutations — remove_file, merge_from — still have their
+    // source of truth. The loaded tables stay valid until then.
+    entries_.reserve(location_count);
+    for (const auto& bucket : buckets_) {
+        for (uint32_t i = 0; i < bucket.count; ++i) {
+            entries_.emplace_back(bucket.hash, locations_[bucket.offset + i]);
         }
+    }
+    if (entries_.size() != location_count) {
+        clear();
+        return false;
+    }
+    dirty_ = false;
+
+    return true;
+}
+
+size_t HashIndex::hash_count() const {
+    ensure_frozen();
+    return unique_hashes_;
+}
+
+size_t HashIndex::location_count() const {
+    return entries_.size();
+}
+
+namespace {
+
+// Buckets up to this size generate all pairs directly
+constexpr size_t EXACT_PAIR_LIMIT = 64;
+
+// Cap on one LSH band group: 500 locations = 124,750 pairs, manageable;
+// larger groups are near-identical boilerplate and are skipped wholesale
+constexpr size_t MAX_GROUP_SIZE = 500;
+
+void emit_pair(
+    const uint64_t hash,
+    const HashLocation& loc_a,
+    const HashLocation& loc_b,
+    const std::vector<uint32_t>* pair_groups,
+    std::vector<ClonePair>& out
+) {
+    // Skip self-overlapping matches (same file, overlapping region)
+    if (loc_a.file_id == loc_b.file_id && loc_a.overlaps(loc_b)) {
+        return;
+    }
+
+    // Cross-group-only mode: both sides in one group means the pair is
+    // already known to that group's own analysis
+    if (pair_groups &&
+        loc_a.file_id < pair_groups->size() &&
+        loc_b.file_id < pair_groups->size() &&
+        (*pair_groups)[loc_a.file_id] == (*pair_groups)[loc_b.file_id]) {
+        return;
+    }
+
+    ClonePair pair{};
+    pair.location_a = loc_a;
+    pair.location_b = loc_b;
+    pair.clone_type = CloneType::TYPE_1;  // Initial classification
+    pair.similarity = 1.0f;  // Exact window match
+    pair.shared_hash = hash;
+
+    out.push_back(pair);
+}
+
+/**
+ * Generate clone pairs for one hash bucket.
+ *
+ * Small buckets emit all pairs (identical windows are clones by
+ * definition). Buckets above max_locations are suppressed outright as
+ * boilerplate (see HashIndex::set_max_locations_per_hash). Large
+ * buckets below the cap are pre-filtered with LSH banding on
+ * the locations' context sketches: only locations whose surroundings
+ * collide in at least one band become candidates, and candidates must
+ * clear the estimated-similarity threshold. Scattered boilerplate
+ * windows with unrelated neighborhoods therefore never reach the
+ * quadratic pair loop.
+ */
+void emit_bucket_pairs(
+    const uint64_t hash,
+    const LocationSpan& locations,
+    const float min_similarity,
+    const size_t max_locations,
+    const std::vector<uint32_t>* pair_groups,
+    std::vector<ClonePair>& out
+) {
+    if (locations.size() < 2 || locations.size() > max_locations) {
+        return;
+    }
 
-        // Generate pairs from all combinations
+    if (locations.size() <= EXACT_PAIR_LIMIT) {
         for (size_t i = 0; i < locations.size(); ++i) {
             for (size_t j = i + 1; j < locations.size(); ++j) {
-                const auto& loc_a = locations[i];
-                const auto& loc_b = locations[j];
+                emit_pair(hash, locations[i], locations[j], pair_groups, out);
+            }
+        }
+        return;
+    }
 
-                // Skip self-overlapping matches (same file, overlapping region)
-                if (loc_a.file_id == loc_b.file_id && loc_a.overlaps(loc_b)) {
-                    continue;
-                }
+    // LSH banding over context sketches
+    std::unordered_map<uint16_t, std::vector<uint32_t>> groups;
+    for (size_t b = 0; b < RegionSketch::BANDS; ++b) {
+        groups.clear();
+        for (uint32_t i = 0; i < locations.size(); ++i) {
+            groups[RegionSketch::band(locations[i].context_sketch, b)].push_back(i);
+        }
 
-                ClonePair pair{};
-                pair.location_a = loc_a;
-                pair.location_b = loc_b;
-                pair.clone_type = CloneType::TYPE_1;  // Initial classification
-                pair.similarity = 1.0f;  // Exact match
-                pair.shared_hash = hash;
+        for (const auto& [key, members] : groups) {
+            if (members.size() < 2 || members.size() > MAX_GROUP_SIZE) {
+                continue;
+            }
 
-                results.push_back(pair);
+            for (size_t i = 0; i < members.size(); ++i) {
+                for (size_t j = i + 1; j < members.size(); ++j) {
+                    const auto& loc_a = locations[members[i]];
+                    const auto& loc_b = locations[members[j]];
+
+                    // Emit each candidate once: only on the first band
+                    // in which the two sketches collide
+                    bool seen_earlier = false;
+                    for (size_t pb = 0; pb < b; ++pb) {
+                        if (RegionSketch::band(loc_a.context_sketch, pb) ==
+                            RegionSketch::band(loc_b.context_sketch, pb)) {
+                            seen_earlier = true;
+                            break;
+                        }
+                    }
+                    if (seen_earlier) {
+                        continue;
+                    }
+
+                    if (RegionSketch::estimate_similarity(
+                            loc_a.context_sketch,
+                            loc_b.context_sketch) < min_similarity) {
+                        continue;
+                    }
+
+                    emit_pair(hash, loc_a, loc_b, pair_groups, out);
+                }
             }
         }
     }
+}
+
+}  // anonymous namespace
+
+std::vector<ClonePair> HashIndex::find_clone_pairs(
+    [[maybe_unused]] size_t min_matches,
+    const float min_similarity
+) const {
+    ensure_frozen();
+    std::vector<ClonePair> results;
+
+    const size_t cap = max_locations_per_hash_ == 0
+        ? std::numeric_limits<size_t>::max()
+        : max_locations_per_hash_;
+    const auto* groups = pair_groups_.empty() ? nullptr : &pair_groups_;
+
+    for (const auto& bucket : buckets_) {
+        if (bucket.count < 2) {
+            continue;
+        }
+        emit_bucket_pairs(
+            bucket.hash,
+            LocationSpan{locations_.data() + bucket.offset, bucket.count},
+            min_similarity,
+            cap,
+            groups,
+            results
+        );
+    }
 
     return results;
 }
 
 std::vector<ClonePair> HashIndex::find_clone_pairs_parallel(
     ThreadPool& pool,
-    const size_t min_matches
+    const size_t min_matches,
+    const float min_similarity,
+    const CandidateSink& on_partition
 ) const {
-    // Limit to prevent combinatorial explosion (same as sequential version)
-    // Collect all hashes with multiple locations into a vector for partitioning
-    // Filter out overly common hashes that would cause memory explosion
-    std::vector<std::pair<uint64_t, const std::vector<HashLocation>*>> work_items;
-    work_items.reserve(index_.size());
-
-    for (const auto& [hash, locations] : index_) {
-        // Only include hashes with 2+ locations but not too many
-        if (constexpr size_t MAX_LOCATIONS_PER_HASH = 500; locations.size() >= 2 && locations.size() <= MAX_LOCATIONS_PER_HASH) {
-            work_items.emplace_back(hash, &locations);
+    ensure_frozen();
+
+    const size_t cap = max_locations_per_hash_ == 0
+        ? std::numeric_limits<size_t>::max()
+        : max_locations_per_hash_;
+
+    // Collect all hashes with multiple locations into a vector for
+    // partitioning; per-bucket limits live in emit_bucket_pairs
+    std::vector<std::pair<uint64_t, LocationSpan>> work_items;
+    work_items.reserve(unique_hashes_);
+
+    for (const auto& bucket : buckets_) {
+        if (bucket.count >= 2 && bucket.count <= cap) {
+            work_items.emplace_back(
+                bucket.hash,
+                LocationSpan{locations_.data() + bucket.offset, bucket.count}
+            );
         }
     }
 
     // For small workloads, use sequential processing
     if (work_items.size() < 100 || pool.size() <= 1) {
-        return find_clone_pairs(min_matches);
+        auto results = find_clone_pairs(min_matches, min_similarity);
+        if (on_partition && !results.empty()) {
+            on_partition(results);
+        }
+        return results;
     }
 
     // Thread-local results to avoid contention
@@ -125,37 +535,21 @@ std::vector<ClonePair> HashIndex::find_clone_pairs_parallel(
 
     // Process work items in parallel
     pool.parallel_for(0, work_items.size(), [&](size_t idx) {
-        const auto& [hash, locations_ptr] = work_items[idx];
-        const auto& locations = *locations_ptr;
+        const auto& [hash, locations] = work_items[idx];
 
         std::vector<ClonePair> local_results;
+        emit_bucket_pairs(hash, locations, min_similarity, cap,
+                          pair_groups_.empty() ? nullptr : &pair_groups_,
+                          local_results);
 
-        // Generate pairs from all combinations
-        for (size_t i = 0; i < locations.size(); ++i) {
-            for (size_t j = i + 1; j < locations.size(); ++j) {
-                const auto& loc_a = locations[i];
-                const auto& loc_b = locations[j];
-
-                // Skip self-overlapping matches
-                if (loc_a.file_id == loc_b.file_id && loc_a.overlaps(loc_b)) {
-                    continue;
-                }
-
-                ClonePair pair{};
-                pair.location_a = loc_a;
-                pair.location_b = loc_b;
-                pair.clone_type = CloneType::TYPE_1;
-                pair.similarity = 1.0f;
-                pair.shared_hash = hash;
-
-                local_results.push_back(pair);
-            }
-        }
-
-        // Merge local results into a thread-specific bucket
+        // Merge local results into a thread-specific bucket. The sink
+        // runs under the same lock, so its invocations are serialized.
         if (!local_results.empty()) {
             const size_t thread_idx = idx % pool.size();
             std::lock_guard<std::mutex> lock(results_mutex);
+            if (on_partition) {
+                on_partition(local_results);
+            }
             auto& bucket = thread_results[thread_idx];
             bucket.insert(bucket.end(), local_results.begin(), local_results.end());
         }
@@ -179,6 +573,136 @@ std::vector<ClonePair> HashIndex::find_clone_pairs_parallel(
     return results;
 }
 
+namespace {
+
+// Sort/group key for consolidation: normalized file pair plus the
+// diagonal (offset between the two regions' token starts)
+struct PairKey {
+    uint32_t file_a;
+    uint32_t file_b;
+    int64_t diagonal;
+
+    bool operator==(const PairKey&) const = default;
+};
+
+PairKey key_of(const ClonePair& pair) {
+    return {
+        pair.location_a.file_id,
+        pair.location_b.file_id,
+        static_cast<int64_t>(pair.location_a.token_start) -
+            static_cast<int64_t>(pair.location_b.token_start)
+    };
+}
+
+// True if outer covers inner in both files
+bool subsumes(const ClonePair& outer, const ClonePair& inner) {
+    const auto covers = [](const HashLocation& o, const HashLocation& i) {
+        return o.token_start <= i.token_start &&
+               o.token_start + o.token_count >= i.token_start + i.token_count;
+    };
+    return covers(outer.location_a, inner.location_a) &&
+           covers(outer.location_b, inner.location_b);
+}
+
+}  // anonymous namespace
+
+std::vector<ClonePair> HashIndex::consolidate_overlaps(std::vector<ClonePair> pairs) {
+    if (pairs.size() < 2) {
+        return pairs;
+    }
+
+    // Normalize orientation so equal regions compare equal: smaller
+    // file_id first, earlier region first within one file
+    for (auto& pair : pairs) {
+        if (pair.location_b.file_id < pair.location_a.file_id ||
+            (pair.location_b.file_id == pair.location_a.file_id &&
+             pair.location_b.token_start < pair.location_a.token_start)) {
+            std::swap(pair.location_a, pair.location_b);
+        }
+    }
+
+    // Pass 1: union overlapping/touching windows along each diagonal.
+    // Same diagonal means the two regions slide in lockstep, so
+    // extending both intervals by the same amount stays exact.
+    std::ranges::sort(pairs, [](const ClonePair& a, const ClonePair& b) {
+        const auto ka = key_of(a);
+        const auto kb = key_of(b);
+        if (ka.file_a != kb.file_a) return ka.file_a < kb.file_a;
+        if (ka.file_b != kb.file_b) return ka.file_b < kb.file_b;
+        if (ka.diagonal != kb.diagonal) return ka.diagonal < kb.diagonal;
+        return a.location_a.token_start < b.location_a.token_start;
+    });
+
+    size_t write = 0;
+    for (size_t read = 1; read < pairs.size(); ++read) {
+        auto& current = pairs[write];
+        const auto& next = pairs[read];
+
+        const uint32_t current_end =
+            current.location_a.token_start + current.location_a.token_count;
+
+        if (key_of(current) == key_of(next) &&
+            next.location_a.token_start <= current_end) {
+            // Union: both regions extend by the same amount
+            const uint32_t next_end =
+                next.location_a.token_start + next.location_a.token_count;
+            if (next_end > current_end) {
+                const uint32_t growth = next_end - current_end;
+                current.location_a.token_count += growth;
+                current.location_b.token_count += growth;
+                current.location_a.end_line = std::max(
+                    current.location_a.end_line, next.location_a.end_line);
+                current.location_b.end_line = std::max(
+                    current.location_b.end_line, next.location_b.end_line);
+            }
+            current.similarity = std::max(current.similarity, next.similarity);
+        } else {
+            pairs[++write] = next;
+        }
+    }
+    pairs.resize(write + 1);
+
+    // Pass 2: drop pairs subsumed in both files by a longer survivor
+    // (typically repeated code matching across several diagonals).
+    // Sorting long-regions-first per file pair means a kept pair can
+    // never be subsumed by a later one.
+    std::ranges::sort(pairs, [](const ClonePair& a, const ClonePair& b) {
+        if (a.location_a.file_id != b.location_a.file_id)
+            return a.location_a.file_id < b.location_a.file_id;
+        if (a.location_b.file_id != b.location_b.file_id)
+            return a.location_b.file_id < b.location_b.file_id;
+        if (a.location_a.token_start != b.location_a.token_start)
+            return a.location_a.token_start < b.location_a.token_start;
+        return a.location_a.token_count > b.location_a.token_count;
+    });
+
+    std::vector<ClonePair> kept;
+    kept.reserve(pairs.size());
+    size_t group_begin = 0;
+
+    for (const auto& pair : pairs) {
+        // New file pair starts a new group
+        if (!kept.empty() &&
+            (kept.back().location_a.file_id != pair.location_a.file_id ||
+             kept.back().location_b.file_id != pair.location_b.file_id)) {
+            group_begin = kept.size();
+        }
+
+        bool covered = false;
+        for (size_t i = kept.size(); i > group_begin; --i) {
+            if (subsumes(kept[i - 1], pair)) {
+                covered = true;
+                break;
+            }
+        }
+        if (!covered) {
+            kept.push_back(pair);
+        }
+    }
+
+    return kept;
+}
+
 std::vector<ClonePair> HashIndex::merge_adjacent_clones(
     std::vector<ClonePair> pairs,
     size_t max_gap
@@ -280,24 +804,38 @@ std::vector<ClonePair> HashIndex::filter_by_size(
 }
 
 HashIndex::Stats HashIndex::get_stats() const {
+    ensure_frozen();
+
     Stats stats{};
     stats.total_files = file_paths_.size();
-    stats.total_hashes = index_.size();
-    stats.total_locations = 0;
+    stats.total_hashes = unique_hashes_;
+    stats.total_locations = entries_.size();
     stats.duplicate_hashes = 0;
     stats.max_locations_per_hash = 0;
 
-    for (const auto& locations : index_ | std::views::values) {
-        stats.total_locations += locations.size();
-        if (locations.size() > 1) {
+    const size_t cap = max_locations_per_hash_ == 0
+        ? std::numeric_limits<size_t>::max()
+        : max_locations_per_hash_;
+
+    for (const auto& bucket : buckets_) {
+        if (bucket.count > 1) {
             stats.duplicate_hashes++;
         }
         stats.max_locations_per_hash = std::max(
             stats.max_locations_per_hash,
-            locations.size()
+            static_cast<size_t>(bucket.count)
         );
+        if (bucket.count > cap) {
+            stats.suppressed_hashes++;
+            stats.suppressed_locations += bucket.count;
+            stats.suppressed.emplace_back(bucket.hash, bucket.count);
+        }
     }
 
+    // Hottest hashes first, so truncated views keep the worst offenders
+    std::sort(stats.suppressed.begin(), stats.suppressed.end(),
+              [](const auto& a, const auto& b) { return a.second > b.second; });
+
     return stats;
 }
 
@@ -320,63 +858,101 @@ HashIndexBuilder::HashIndexBuilder(HashIndex& existing_index, size_t window_size
 }
 
 void HashIndexBuilder::add_file(const TokenizedFile& file, bool use_normalized) {
-    if (file.tokens.empty()) {
+    // AoS convenience path: build columns into a throwaway arena and
+    // delegate to the SoA implementation
+    Arena arena;
+    add_file(file.path, TokenColumns::from_tokens(file.tokens, arena), use_normalized);
+}
+
+void HashIndexBuilder::add_file(
+    const std::string& path,
+    const TokenColumns& columns,
+    const bool use_normalized
+) {
+    if (columns.empty()) {
         return;
     }
 
     HashIndex& target_index = use_external_ ? *external_index_ : index_;
-    const uint32_t file_id = target_index.register_file(file.path);
-
-    // Extract hash values from tokens
-    std::vector<uint64_t> token_hashes;
-    token_hashes.reserve(file.tokens.size());
-
-    for (const auto& token : file.tokens) {
-        // Skip structural tokens that shouldn't participate in similarity
-        if (token.type == TokenType::NEWLINE ||
-            token.type == TokenType::INDENT ||
-            token.type == TokenType::DEDENT) {
+    const uint32_t file_id = target_index.register_file(path);
+
+    // Extract hash values, skipping structural tokens that shouldn't
+    // participate in similarity; remember each hash's original token index
+    const uint32_t* hash_column =
+        use_normalized ? columns.normalized_hashes : columns.original_hashes;
+
+    token_hashes_.clear();
+    token_mapping_.clear();
+    token_hashes_.reserve(columns.count);
+    token_mapping_.reserve(columns.count);
+
+    for (size_t i = 0; i < columns.count; ++i) {
+        const auto type = columns.types[i];
+        if (type == TokenType::NEWLINE ||
+            type == TokenType::INDENT ||
+            type == TokenType::DEDENT) {
             continue;
         }
 
-        uint64_t hash = use_normalized ? token.normalized_hash : token.original_hash;
-        token_hashes.push_back(hash);
+        token_hashes_.push_back(hash_column[i]);
+        token_mapping_.push_back(i);
     }
 
-    if (token_hashes.size() < window_size_) {
+    if (token_hashes_.size() < window_size_) {
         return;  // File too small
     }
 
     // Compute rolling hashes and add to index
-    auto window_hashes = HashSequence::compute_all(token_hashes, window_size_);
-
-    // Map token index (excluding structural) back to the original token
-    std::vector<size_t> token_mapping;
-    for (size_t i = 0; i < file.tokens.size(); ++i) {
-        if (const auto& token = file.tokens[i]; token.type != TokenType::NEWLINE &&
-            token.type != TokenType::INDENT &&
-            token.type != TokenType::DEDENT) {
-            token_mapping.push_back(i);
-        }
-    }
+    auto window_hashes = HashSequence::compute_all(token_hashes_, window_size_);
+
+    // One bulk update per file keeps the instrumentation off the hot loop
+    AnalysisMetrics::global().add_hashes_inserted(window_hashes.size());
+
+    // Build the file's run into scratch buffers; the known window count
+    // sizes everything once
+    window_hashes_.clear();
+    window_locations_.clear();
+    window_hashes_.reserve(window_hashes.size());
+    window_locations_.reserve(window_hashes.size());
 
     for (const auto& [pos, hash] : window_hashes) {
         // Map position back to original token array
-        const size_t orig_start = token_mapping[pos];
-        const size_t orig_end = token_mapping[std::min(pos + window_size_ - 1,
-                                                  token_mapping.size() - 1)];
+        const size_t orig_start = token_mapping_[pos];
+        const size_t orig_end = token_mapping_[std::min(pos + window_size_ - 1,
+                                                  token_mapping_.size() - 1)];
 
         HashLocation loc{};
         loc.file_id = file_id;
-        loc.start_line = file.tokens[orig_start].line;
-        loc.end_line = file.tokens[orig_end].line;
-        loc.start_col = file.tokens[orig_start].column;
-        loc.end_col = file.tokens[orig_end].column + file.tokens[orig_end].length;
+        loc.start_line = columns.lines[orig_start];
+        loc.end_line = columns.lines[orig_end];
+        loc.start_col = columns.columns[orig_start];
+        loc.end_col = columns.columns[orig_end] + columns.lengths[orig_end];
         loc.token_start = static_cast<uint32_t>(pos);
         loc.token_count = static_cast<uint32_t>(window_size_);
 
-        target_index.add_hash(hash, loc);
+        // Sketch a neighborhood one window before through two windows
+        // after this position: identical windows in unrelated
+        // surroundings get different sketches and are pre-filtered out
+        // of pair generation
+        const size_t ctx_begin = pos > window_size_ ? pos - window_size_ : 0;
+        const size_t ctx_end = std::min(pos + 2 * window_size_, token_hashes_.size());
+        loc.context_sketch = RegionSketch::compute(
+            token_hashes_.data() + ctx_begin,
+            ctx_end - ctx_begin
+        );
+
+        window_hashes_.push_back(hash);
+        window_locations_.push_back(loc);
     }
+
+    // Spill mode: hand the windows to the sink instead of the index
+    if (window_sink_) {
+        window_sink_(window_hashes_, window_locations_);
+        return;
+    }
+
+    // One bulk insert per file: a single growth check on the ingest log
+    target_index.add_hashes(window_hashes_, window_locations_);
 }
 
 }  // namespace aegis::similarity
@@ -1,14 +1,36 @@
 #pragma once
 
 #include "models/clone_types.hpp"
+#include "models/token_columns.hpp"
+#include "utils/string_interner.hpp"
 #include "utils/thread_pool.hpp"
 #include <unordered_map>
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <functional>
+#include <iosfwd>
+#include <span>
 
 namespace aegis::similarity {
 
+/**
+ * Non-owning view over the locations stored for one hash.
+ *
+ * Points into the index's compacted location arena; valid until the
+ * index is next modified.
+ */
+struct LocationSpan {
+    const HashLocation* data = nullptr;
+    size_t count = 0;
+
+    const HashLocation* begin() const { return data; }
+    const HashLocation* end() const { return data + count; }
+    size_t size() const { return count; }
+    [[nodiscard]] bool empty() const { return count == 0; }
+    const HashLocation& operator[](size_t i) const { return data[i]; }
+};
+
 /**
  * Inverted index mapping rolling hashes to their source locations.
  *
@@ -16,6 +38,13 @@ namespace aegis::similarity {
  * 1. Storing all hash -> location mappings during analysis
  * 2. Finding potential clones by looking up duplicate hashes
  * 3. Merging adjacent clone pairs into larger regions
+ *
+ * Storage layout: add_hash() appends to a flat ingest log; the first
+ * query compacts the log into an open-addressing bucket table plus one
+ * contiguous HashLocation arena (counting-sort style two-pass build).
+ * Buckets hold an offset+count into the arena, so lookup and full-index
+ * iteration touch contiguous memory instead of one heap node and one
+ * heap vector per hash.
  */
 class HashIndex {
 public:
@@ -24,13 +53,20 @@ public:
      */
     void clear();
 
+    /**
+     * Drop every hash and location but keep the file registry, so
+     * file_ids stay valid. Used by out-of-core matching to reuse one
+     * index across hash-range partitions without re-registering files.
+     */
+    void clear_locations();
+
     /**
      * Register a file and get its ID.
      *
      * @param path The file path
      * @return The assigned file ID
      */
-    uint32_t register_file(const std::string& path);
+    uint32_t register_file(std::string_view path);
 
     /**
      * Get the path for a file ID.
@@ -50,15 +86,77 @@ public:
      */
     void add_hash(uint64_t hash, const HashLocation& location);
 
+    /**
+     * Bulk-ingest a run of hashes and their locations (parallel
+     * arrays, one location per hash). Reserves the ingest log once for
+     * the whole run, so per-file insertion costs one growth check
+     * instead of one per window.
+     */
+    void add_hashes(
+        std::span<const uint64_t> hashes,
+        std::span<const HashLocation> locations
+    );
+
+    /**
+     * Reserve ingest-log capacity for `additional` more locations on
+     * top of the current contents. Callers that know the corpus size
+     * up front (tokens - window_size + 1 windows per file) use this to
+     * avoid repeated reallocation of a very large log.
+     */
+    void reserve(size_t additional);
+
     /**
      * Get all locations for a specific hash.
+     * Returns an empty span if the hash is not present.
      */
-    const std::vector<HashLocation>* get_locations(uint64_t hash) const;
+    LocationSpan get_locations(uint64_t hash) const;
+
+    /**
+     * Remove all hash locations belonging to a file.
+     *
+     * Used by incremental analysis to invalidate stale entries before
+     * re-indexing a modified file. The file registration (id and path)
+     * is kept so the file_id can be reused by the re-indexed content.
+     *
+     * @param file_id The file whose locations should be dropped
+     */
+    void remove_file(uint32_t file_id);
+
+    /**
+     * Absorb another index's contents, leaving it empty.
+     *
+     * Files registered in `other` are re-registered here (existing
+     * registrations are reused) and its locations are appended with
+     * file ids remapped accordingly. Used to combine per-thread index
+     * shards after parallel construction.
+     */
+    void merge_from(HashIndex&& other);
+
+    /**
+     * Serialize the index to a binary stream as a flat image of the
+     * frozen tables: file registry, then the full bucket table and
+     * location arena dumped raw. Offsets in the image are
+     * table-relative, so the layout is relocatable.
+     *
+     * @return true on success
+     */
+    bool save(std::ostream& out) const;
+
+    /**
+     * Load an index previously written with save().
+     * Replaces the current contents. The image lands directly in the
+     * frozen (query-ready) form — a handful of bulk reads, no
+     * re-hashing — which is what makes snapshot-based warm startup
+     * cheap.
+     *
+     * @return true on success, false if the stream is invalid/corrupt
+     */
+    bool load(std::istream& in);
 
     /**
      * Get the number of unique hashes in the index.
      */
-    size_t hash_count() const { return index_.size(); }
+    size_t hash_count() const;
 
     /**
      * Get total number of locations stored.
@@ -69,12 +167,27 @@ public:
      * Find all clone pairs in the index.
      *
      * A clone pair is generated for each pair of locations that share
-     * the same hash and don't overlap.
+     * the same hash and don't overlap. Oversized buckets are
+     * pre-filtered with LSH banding over the locations' context
+     * sketches (see RegionSketch) instead of the full quadratic pair
+     * loop.
      *
      * @param min_matches Minimum hash matches to consider (default 1)
+     * @param min_similarity Estimated-similarity floor for candidates
+     *        surviving the LSH pre-filter (0 = keep all collisions)
      * @return Vector of clone pairs
      */
-    std::vector<ClonePair> find_clone_pairs(size_t min_matches = 1) const;
+    std::vector<ClonePair> find_clone_pairs(
+        size_t min_matches = 1,
+        float min_similarity = 0.0f
+    ) const;
+
+    /**
+     * Sink for candidate pairs surfaced while pair finding is still
+     * running. Invocations are serialized (the sink needs no locking of
+     * its own) but may come from pool threads.
+     */
+    using CandidateSink = std::function<void(const std::vector<ClonePair>&)>;
 
     /**
      * Find all clone pairs in the index using parallel processing.
@@ -84,13 +197,39 @@ public:
      *
      * @param pool Thread pool to use for parallel execution
      * @param min_matches Minimum hash matches to consider (default 1)
+     * @param min_similarity Estimated-similarity floor for candidates
+     *        surviving the LSH pre-filter (0 = keep all collisions)
+     * @param on_partition Optional sink invoked with each hash
+     *        partition's raw pairs as it is scanned, before the caller
+     *        merges or filters anything
      * @return Vector of clone pairs
      */
     std::vector<ClonePair> find_clone_pairs_parallel(
         ThreadPool& pool,
-        size_t min_matches = 1
+        size_t min_matches = 1,
+        float min_similarity = 0.0f,
+        const CandidateSink& on_partition = {}
     ) const;
 
+    /**
+     * Collapse the per-window redundancy in a raw pair list.
+     *
+     * Overlapping hash windows turn one real clone of N tokens into
+     * ~N-window_size nearly identical pairs. These all lie on the same
+     * "diagonal" (constant token_start offset between the two files),
+     * so a sorted sweep per (file pair, diagonal) unions them into one
+     * interval; a second sweep drops pairs whose regions are subsumed
+     * in both files by a surviving pair. Runs in O(n log n) on the raw
+     * list, so merge, classification and Type-3 extension only ever
+     * see the consolidated survivors.
+     *
+     * @param pairs Raw pairs out of the matcher (consumed)
+     * @return Consolidated pairs, orientation-normalized
+     */
+    static std::vector<ClonePair> consolidate_overlaps(
+        std::vector<ClonePair> pairs
+    );
+
     /**
      * Merge adjacent clone pairs into larger clone regions.
      *
@@ -120,6 +259,33 @@ public:
         size_t min_tokens
     );
 
+    /**
+     * Set the hot-hash suppression cap: hashes with more locations than
+     * this are treated as boilerplate and never generate pairs. Pass 0
+     * to disable the cap. Default is DEFAULT_MAX_LOCATIONS_PER_HASH.
+     */
+    void set_max_locations_per_hash(size_t cap) {
+        max_locations_per_hash_ = cap;
+    }
+
+    /**
+     * Restrict pair generation to locations in different groups.
+     *
+     * `group_of_file` maps file_id to an opaque group; when non-empty,
+     * pairs whose two sides share a group are dropped at emission, so
+     * intra-group buckets never reach the quadratic pair loop's output.
+     * Used by federated analysis, where each group is one repository's
+     * artifact and intra-repo clones are already known. File ids beyond
+     * the vector are never filtered. Pass an empty vector to clear.
+     */
+    void set_pair_groups(std::vector<uint32_t> group_of_file) {
+        pair_groups_ = std::move(group_of_file);
+    }
+
+    size_t max_locations_per_hash() const { return max_locations_per_hash_; }
+
+    static constexpr size_t DEFAULT_MAX_LOCATIONS_PER_HASH = 5000;
+
     /**
      * Get statistics about the index.
      */
@@ -129,19 +295,54 @@ public:
         size_t total_locations;
         size_t duplicate_hashes;  // Hashes appearing more than once
         size_t max_locations_per_hash;
+
+        // Hashes over the suppression cap, with their location counts
+        size_t suppressed_hashes;
+        size_t suppressed_locations;
+        std::vector<std::pair<uint64_t, size_t>> suppressed;
     };
 
     Stats get_stats() const;
 
 private:
-    // Hash -> list of locations
-    std::unordered_map<uint64_t, std::vector<HashLocation>> index_;
+    // One slot of the open-addressing table. count == 0 marks an empty
+    // slot; occupied slots reference [offset, offset + count) in locations_.
+    struct Bucket {
+        uint64_t hash = 0;
+        uint32_t offset = 0;
+        uint32_t count = 0;
+    };
+
+    // Flat ingest log; mutations only ever append here (or erase from here)
+    std::vector<std::pair<uint64_t, HashLocation>> entries_;
+
+    // Frozen query structures, rebuilt lazily from entries_ on first query
+    // after a mutation. buckets_ is always a power of two in size.
+    mutable std::vector<Bucket> buckets_;
+    mutable std::vector<HashLocation> locations_;
+    mutable size_t unique_hashes_ = 0;
+    mutable bool dirty_ = false;
+
+    // File path registry: paths interned once, addressed by file_id
+    StringInterner file_paths_;
+
+    // Hot-hash suppression cap for pair generation (0 = no cap)
+    size_t max_locations_per_hash_ = DEFAULT_MAX_LOCATIONS_PER_HASH;
 
-    // File ID -> file path
-    std::vector<std::string> file_paths_;
+    // file_id -> group for cross-group-only pair generation (empty = off)
+    std::vector<uint32_t> pair_groups_;
 
-    // File path -> file ID (for deduplication)
-    std::unordered_map<std::string, uint32_t> path_to_id_;
+    /**
+     * Compact the ingest log into the bucket table and location arena.
+     * No-op if nothing changed since the last freeze.
+     */
+    void ensure_frozen() const;
+
+    /**
+     * Locate the bucket for a hash (requires a frozen index).
+     * Returns nullptr if the hash is not present.
+     */
+    const Bucket* find_bucket(uint64_t hash) const;
 };
 
 /**
@@ -173,6 +374,39 @@ public:
      */
     void add_file(const TokenizedFile& file, bool use_normalized = true);
 
+    /**
+     * Add a file to the index from its SoA token columns.
+     *
+     * This is the hot-path variant: the hashing loop walks only the
+     * columns it needs instead of striding over 16-byte token structs.
+     *
+     * @param path The file path (for registration)
+     * @param columns SoA view over the file's tokens
+     * @param use_normalized Use normalized hashes (for Type-2 detection)
+     */
+    void add_file(
+        const std::string& path,
+        const TokenColumns& columns,
+        bool use_normalized = true
+    );
+
+    /**
+     * Sink for a file's computed windows (parallel spans, one location
+     * per hash). The spans are only valid during the call.
+     */
+    using WindowSink = std::function<void(
+        std::span<const uint64_t> hashes,
+        std::span<const HashLocation> locations
+    )>;
+
+    /**
+     * Divert windows to a sink instead of inserting them. Files are
+     * still registered on the index (ids stay consistent); only the
+     * hash insertion is bypassed. Used by out-of-core matching to spill
+     * windows to disk instead of growing the in-memory index.
+     */
+    void set_window_sink(WindowSink sink) { window_sink_ = std::move(sink); }
+
     /**
      * Get the built index.
      */
@@ -184,6 +418,14 @@ private:
     HashIndex index_;               // Internal index (when not using external)
     HashIndex* external_index_ = nullptr;  // External index (when provided)
     bool use_external_ = false;
+    WindowSink window_sink_;        // When set, windows bypass the index
+
+    // Per-file scratch, reused across add_file calls so a shard's worth
+    // of files costs a handful of allocations instead of four per file
+    std::vector<uint64_t> token_hashes_;
+    std::vector<size_t> token_mapping_;
+    std::vector<uint64_t> window_hashes_;
+    std::vector<HashLocation> window_locations_;
 };
 
 }  // namespace aegis::similarity
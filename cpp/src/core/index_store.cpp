@@ -0,0 +1,127 @@
+#include "core/index_store.hpp"
+#include <fstream>
+
+namespace aegis::similarity {
+
+namespace {
+
+// Store format: magic + version, then the HashIndex section (its own
+// magic/version), then the fingerprint table.
+constexpr uint32_t STORE_MAGIC = 0x41454953;  // "AEIS"
+constexpr uint32_t STORE_VERSION = 1;
+
+template<typename T>
+void write_pod(std::ostream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+bool read_pod(std::istream& in, T& value) {
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return in.good();
+}
+
+}  // anonymous namespace
+
+bool IndexStore::load(const std::filesystem::path& file) {
+    index.clear();
+    fingerprints.clear();
+
+    std::ifstream in(file, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    if (!read_pod(in, magic) || magic != STORE_MAGIC) return false;
+    if (!read_pod(in, version) || version != STORE_VERSION) return false;
+
+    if (!index.load(in)) {
+        return false;
+    }
+
+    uint64_t entry_count = 0;
+    if (!read_pod(in, entry_count)) {
+        index.clear();
+        return false;
+    }
+
+    for (uint64_t i = 0; i < entry_count; ++i) {
+        uint32_t path_size = 0;
+        if (!read_pod(in, path_size)) {
+            index.clear();
+            fingerprints.clear();
+            return false;
+        }
+
+        std::string path(path_size, '\0');
+        in.read(path.data(), path_size);
+
+        FileFingerprint fp;
+        if (!in.good() ||
+            !read_pod(in, fp.mtime) ||
+            !read_pod(in, fp.size) ||
+            !read_pod(in, fp.line_count)) {
+            index.clear();
+            fingerprints.clear();
+            return false;
+        }
+
+        fingerprints[std::move(path)] = fp;
+    }
+
+    return true;
+}
+
+bool IndexStore::save(const std::filesystem::path& file) const {
+    std::error_code ec;
+    if (const auto parent = file.parent_path(); !parent.empty()) {
+        std::filesystem::create_directories(parent, ec);
+    }
+
+    std::ofstream out(file, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+
+    write_pod(out, STORE_MAGIC);
+    write_pod(out, STORE_VERSION);
+
+    if (!index.save(out)) {
+        return false;
+    }
+
+    write_pod(out, static_cast<uint64_t>(fingerprints.size()));
+    for (const auto& [path, fp] : fingerprints) {
+        write_pod(out, static_cast<uint32_t>(path.size()));
+        out.write(path.data(), static_cast<std::streamsize>(path.size()));
+        write_pod(out, fp.mtime);
+        write_pod(out, fp.size);
+        write_pod(out, fp.line_count);
+    }
+
+    return out.good();
+}
+
+std::optional<FileFingerprint> IndexStore::fingerprint(
+    const std::filesystem::path& path
+) {
+    std::error_code ec;
+    const auto mtime = std::filesystem::last_write_time(path, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+
+    const auto size = std::filesystem::file_size(path, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+
+    FileFingerprint fp;
+    fp.mtime = static_cast<int64_t>(mtime.time_since_epoch().count());
+    fp.size = size;
+    return fp;
+}
+
+}  // namespace aegis::similarity
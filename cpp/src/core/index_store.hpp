@@ -0,0 +1,71 @@
+#pragma once
+
+#include "core/hash_index.hpp"
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+
+namespace aegis::similarity {
+
+/**
+ * Fingerprint used to decide whether a file changed between runs.
+ *
+ * mtime + size are cheap (one stat per file) and catch the common case;
+ * a full content hash is intentionally avoided on the delta-detection
+ * path so an unchanged 40k-file tree costs one stat per file, not one
+ * read per file.
+ */
+struct FileFingerprint {
+    int64_t mtime = 0;        // last_write_time, epoch ticks
+    uint64_t size = 0;        // file size in bytes
+    uint32_t line_count = 0;  // total lines (needed for hotspot metrics)
+
+    bool matches(const FileFingerprint& other) const {
+        return mtime == other.mtime && size == other.size;
+    }
+};
+
+/**
+ * Persistent on-disk store for incremental analysis.
+ *
+ * Holds the HashIndex from a previous run together with per-file
+ * fingerprints, so a new analysis can:
+ * 1. Load the previous index
+ * 2. Stat all discovered files and compare fingerprints
+ * 3. Remove stale HashLocation entries for modified/deleted files
+ * 4. Re-tokenize and re-index only the changed files
+ *
+ * The store is a single binary file; see HashIndex::save() for the
+ * index section format.
+ */
+class IndexStore {
+public:
+    HashIndex index;
+    std::map<std::string, FileFingerprint> fingerprints;
+
+    /**
+     * Load a store written by save().
+     *
+     * @return true on success; on failure the store is left empty
+     */
+    bool load(const std::filesystem::path& file);
+
+    /**
+     * Write the store to disk. Creates parent directories if needed.
+     *
+     * @return true on success
+     */
+    bool save(const std::filesystem::path& file) const;
+
+    /**
+     * Compute the current fingerprint of a file on disk.
+     *
+     * @return Fingerprint, or nullopt if the file can't be stat'd
+     */
+    static std::optional<FileFingerprint> fingerprint(
+        const std::filesystem::path& path
+    );
+};
+
+}  // namespace aegis::similarity
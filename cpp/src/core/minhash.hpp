@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace aegis::similarity {
+
+/**
+ * Compact b-bit MinHash sketch of a token region.
+ *
+ * 16 slots of 4 bits packed into one uint64_t: slot i keeps the low
+ * 4 bits of the minimum of the region's token hashes under the i-th
+ * seeded permutation. The fraction of matching slots between two
+ * sketches estimates the Jaccard similarity of the underlying regions
+ * (with a ~1/16 per-slot noise floor for unrelated regions).
+ *
+ * Used as an LSH pre-filter: sketches split into 4 bands of 4 slots,
+ * and only locations colliding in at least one band are considered
+ * candidate pairs. Boilerplate windows (imports, getter patterns) that
+ * share a rolling hash but sit in unrelated surroundings land in
+ * different bands and never generate a pair.
+ */
+struct RegionSketch {
+    static constexpr size_t SLOTS = 16;
+    static constexpr size_t BANDS = 4;
+    static constexpr size_t SLOTS_PER_BAND = SLOTS / BANDS;
+
+    /**
+     * Sketch a region of token hashes. Empty regions sketch to 0.
+     */
+    static uint64_t compute(const uint64_t* hashes, size_t count) {
+        if (count == 0) {
+            return 0;
+        }
+
+        uint64_t sketch = 0;
+        for (size_t slot = 0; slot < SLOTS; ++slot) {
+            uint64_t min_value = UINT64_MAX;
+            const uint64_t seed = SEEDS[slot];
+            for (size_t i = 0; i < count; ++i) {
+                const uint64_t mixed = mix(hashes[i] ^ seed);
+                if (mixed < min_value) {
+                    min_value = mixed;
+                }
+            }
+            sketch |= (min_value & 0xF) << (slot * 4);
+        }
+        return sketch;
+    }
+
+    /**
+     * Estimated Jaccard similarity: fraction of matching slots.
+     */
+    static float estimate_similarity(uint64_t a, uint64_t b) {
+        size_t matches = 0;
+        for (size_t slot = 0; slot < SLOTS; ++slot) {
+            if (((a ^ b) >> (slot * 4) & 0xF) == 0) {
+                ++matches;
+            }
+        }
+        return static_cast<float>(matches) / static_cast<float>(SLOTS);
+    }
+
+    /**
+     * Extract one 16-bit LSH band (4 consecutive slots).
+     */
+    static uint16_t band(uint64_t sketch, size_t band_idx) {
+        return static_cast<uint16_t>(sketch >> (band_idx * 16));
+    }
+
+private:
+    static uint64_t mix(uint64_t x) {
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    static constexpr uint64_t SEEDS[SLOTS] = {
+        0x9ae16a3b2f90404fULL, 0xc3a5c85c97cb3127ULL,
+        0xb492b66fbe98f273ULL, 0x9ddfea08eb382d69ULL,
+        0x589965cc75374cc3ULL, 0x1b873593aaf8ca6bULL,
+        0xff51afd7ed558ccdULL, 0xc4ceb9fe1a85ec53ULL,
+        0x87c37b91114253d5ULL, 0x4cf5ad432745937fULL,
+        0x52dce729d9e4a2c9ULL, 0x38495ab5cc375fb1ULL,
+        0x6c62272e07bb0142ULL, 0x27d4eb2f165667c5ULL,
+        0x165667b19e3779f9ULL, 0x85ebca6b27d4eb2fULL,
+    };
+};
+
+}  // namespace aegis::similarity
@@ -5,6 +5,7 @@ namespace aegis::similarity {
 RollingHash::RollingHash(const size_t window_size)
     : window_size_(window_size)
     , base_power_(1)
+    , window_(window_size)
 {
     // Pre-calculate BASE^(window_size-1) mod MOD
     for (size_t i = 1; i < window_size_; ++i) {
@@ -14,33 +15,38 @@ RollingHash::RollingHash(const size_t window_size)
 
 void RollingHash::reset() {
     hash_ = 0;
-    window_.clear();
+    head_ = 0;
+    count_ = 0;
 }
 
 std::optional<uint64_t> RollingHash::push(const uint64_t token_hash) {
-    // If window is already full, remove oldest token first
-    if (window_.size() >= window_size_) {
-        // Remove oldest token from hash
+    if (count_ >= window_size_) {
+        // Full: evict the oldest token and reuse its ring slot
         // hash = hash - old_token * BASE^(window_size-1)
-        uint64_t old_token = window_.front();
-        window_.pop_front();
+        const uint64_t old_token = window_[head_];
 
         // Subtract old token contribution (handle potential underflow)
-        uint64_t old_contribution = (old_token * base_power_) % MOD;
+        const uint64_t old_contribution = (old_token * base_power_) % MOD;
         if (hash_ >= old_contribution) {
             hash_ = hash_ - old_contribution;
         } else {
             hash_ = MOD - (old_contribution - hash_);
         }
+
+        window_[head_] = token_hash;
+        head_ = (head_ + 1 == window_size_) ? 0 : head_ + 1;
+    } else {
+        // Filling: head_ stays at the oldest slot (0 until first wrap)
+        window_[(head_ + count_) % window_size_] = token_hash;
+        ++count_;
     }
 
     // Add new token to hash
     // hash = hash * BASE + new_token
     hash_ = (hash_ * BASE + token_hash) % MOD;
-    window_.push_back(token_hash);
 
     // Return hash only if window is now full
-    if (window_.size() >= window_size_) {
+    if (count_ >= window_size_) {
         return hash_;
     }
 
@@ -80,22 +86,40 @@ std::vector<std::pair<size_t, uint64_t>> HashSequence::compute_all(
 ) {
     std::vector<std::pair<size_t, uint64_t>> result;
 
-    if (token_hashes.size() < window_size) {
+    if (window_size == 0 || token_hashes.size() < window_size) {
         return result;
     }
 
-    // Pre-allocate for efficiency
-    result.reserve(token_hashes.size() - window_size + 1);
+    const size_t count = token_hashes.size();
+    result.reserve(count - window_size + 1);
 
-    RollingHash hasher(window_size);
+    // Batch kernel: slide directly over the input array instead of going
+    // through RollingHash::push(). No ring-buffer maintenance, no
+    // std::optional per token, no branch on window fill state — just the
+    // multiply-add recurrence over contiguous memory. (The 64-bit modular
+    // multiply has no SIMD equivalent on AVX2/NEON, so the scalar
+    // recurrence with precomputed BASE^(w-1) is the fast path here.)
+    const uint64_t base_power = RollingHash::power_mod(window_size - 1);
 
-    for (size_t i = 0; i < token_hashes.size(); ++i) {
-        if (auto hash = hasher.push(token_hashes[i]); hash.has_value()) {
-            // Position is the start of the window
-            size_t start_pos = i - window_size + 1;
-            result.emplace_back(start_pos, *hash);
-        }
+    // Initial window
+    uint64_t hash = 0;
+    for (size_t i = 0; i < window_size; ++i) {
+        hash = (hash * RollingHash::BASE + token_hashes[i]) % RollingHash::MOD;
     }
+    result.emplace_back(0, hash);
+
+    // Slide: remove the outgoing token's contribution, shift in the new one
+    for (size_t i = window_size; i < count; ++i) {
+        const uint64_t old_contribution =
+            (token_hashes[i - window_size] * base_power) % RollingHash::MOD;
+        hash = hash >= old_contribution
+            ? hash - old_contribution
+            : RollingHash::MOD - (old_contribution - hash);
+        hash = (hash * RollingHash::BASE + token_hashes[i]) % RollingHash::MOD;
+
+        result.emplace_back(i - window_size + 1, hash);
+    }
+
     return result;
 }
 
@@ -1,7 +1,6 @@
 #pragma once
 
 #include <cstdint>
-#include <deque>
 #include <optional>
 #include <vector>
 
@@ -58,12 +57,12 @@ public:
     /**
      * Get the number of tokens currently in the window.
      */
-    size_t current_size() const { return window_.size(); }
+    size_t current_size() const { return count_; }
 
     /**
      * Check if the window is full.
      */
-    bool is_full() const { return window_.size() >= window_size_; }
+    bool is_full() const { return count_ >= window_size_; }
 
     /**
      * Compute hash for a sequence of token hashes (non-rolling).
@@ -83,8 +82,13 @@ public:
 private:
     size_t window_size_;
     uint64_t hash_ = 0;
-    uint64_t base_power_;  // BASE^(window_size-1) mod MOD
-    std::deque<uint64_t> window_;
+    uint64_t base_power_;          // BASE^(window_size-1) mod MOD
+
+    // Fixed-size ring buffer: one flat allocation at construction,
+    // no per-push allocator traffic (unlike the previous std::deque)
+    std::vector<uint64_t> window_;
+    size_t head_ = 0;              // Index of the oldest token
+    size_t count_ = 0;             // Tokens currently in the window
 };
 
 /**
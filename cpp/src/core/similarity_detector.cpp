@@ -1,18 +1,129 @@
 #include "core/similarity_detector.hpp"
 #include "core/clone_extender.hpp"
+#include "core/index_store.hpp"
+#include "utils/bounded_queue.hpp"
 #include "utils/file_utils.hpp"
+#include "utils/metrics.hpp"
+#include "utils/snippet_reader.hpp"
 #include "tokenizers/python_normalizer.hpp"
+#include <unistd.h>
 #include <chrono>
 #include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <future>
 #include <mutex>
+#include <set>
+#include <string_view>
+#include <thread>
 
 namespace aegis::similarity {
 
-// Default cache capacity (number of files)
-constexpr size_t DEFAULT_CACHE_CAPACITY = 1000;
+// Default token cache budget: eviction is charged per token, so this
+// bounds memory on heterogeneous corpora where one generated file can
+// be a thousand times bigger than a typical script
+constexpr size_t DEFAULT_CACHE_TOKEN_BUDGET = 4'000'000;
+
+// Streamed discovery: queue bound between the walk and tokenization,
+// and how many walker threads list directories. Discovery is I/O-bound,
+// so a couple of walkers saturate it without stealing compute threads.
+constexpr size_t DISCOVERY_QUEUE_CAPACITY = 1024;
+constexpr size_t DISCOVERY_WALKERS = 2;
+
+// Out-of-core matching (max_memory_mb): hard cap on hash-range
+// partitions; beyond this the per-pass overhead dominates and the
+// index slice is tiny anyway
+constexpr size_t MAX_INDEX_PARTITIONS = 64;
+
+// One spill record: the window hash followed by its raw HashLocation
+constexpr size_t SPILL_RECORD_BYTES = sizeof(uint64_t) + sizeof(HashLocation);
+
+namespace {
+
+// Content hash for the identical-file dedup pass (FNV-1a, the same
+// scheme the persistent token cache uses for path hashing)
+uint64_t content_hash(const std::string_view data) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (const unsigned char c : data) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+ * Bookkeeping for the identical-file dedup pass, shared by the
+ * tokenize workers. Content is keyed by (size, FNV-1a); the first file
+ * seen with a given content owns the group and is the only one
+ * tokenized.
+ */
+struct ContentDedup {
+    std::mutex mutex;
+    std::map<std::pair<size_t, uint64_t>, std::string> owners;
+    std::map<std::string, std::vector<std::string>> duplicates;
+
+    // Returns false if this content was already seen; the path is then
+    // recorded as a copy of the first occurrence
+    bool first_occurrence(
+        const std::filesystem::path& path,
+        const std::string_view content
+    ) {
+        const auto key = std::make_pair(content.size(), content_hash(content));
+        std::lock_guard<std::mutex> lock(mutex);
+        auto [it, inserted] = owners.try_emplace(key, path.string());
+        if (!inserted) {
+            duplicates[it->second].push_back(path.string());
+        }
+        return inserted;
+    }
+};
+
+/**
+ * Fold dedup bookkeeping into path-sorted groups. When a worker
+ * tokenized a copy that doesn't sort first, its TokenizedFile is
+ * re-pointed at the group's smallest path so reports stay
+ * deterministic regardless of arrival order — safe because every path
+ * in a group has byte-identical content.
+ */
+void fold_identical_groups(
+    ContentDedup& dedup,
+    std::vector<TokenizedFile>& results,
+    std::vector<std::vector<std::string>>& groups
+) {
+    for (auto& [owner, dups] : dedup.duplicates) {
+        std::vector<std::string> group;
+        group.reserve(dups.size() + 1);
+        group.push_back(owner);
+        group.insert(group.end(),
+                     std::make_move_iterator(dups.begin()),
+                     std::make_move_iterator(dups.end()));
+        std::sort(group.begin(), group.end());
+
+        if (group.front() != owner) {
+            for (auto& tokenized : results) {
+                if (tokenized.path == owner) {
+                    tokenized.path = group.front();
+                    break;
+                }
+            }
+        }
+        groups.push_back(std::move(group));
+    }
+    std::sort(groups.begin(), groups.end());
+}
+
+}  // anonymous namespace
 
 SimilarityDetector::SimilarityDetector(DetectorConfig config)
     : config_(std::move(config))
+    // Eager: the cache is cheap to build (no threads, just shard
+    // tables) and the pointer never changes afterwards, so lock-free
+    // readers like the server's stats handlers can't race the first
+    // analysis initializing it
+    , token_cache_(std::make_unique<TokenCache>(
+          DEFAULT_CACHE_TOKEN_BUDGET,
+          TokenCache::DEFAULT_SHARDS,
+          [](const CachedTokens& entry) { return entry.tokens.tokens.size() + 1; }))
 {
 }
 
@@ -26,8 +137,10 @@ void SimilarityDetector::ensure_initialized() {
         thread_pool_ = std::make_unique<ThreadPool>(num_threads);
     }
 
-    if (!token_cache_) {
-        token_cache_ = std::make_unique<LRUCache<std::string, TokenizedFile>>(DEFAULT_CACHE_CAPACITY);
+    if (!persistent_cache_ && !config_.token_cache_dir.empty()) {
+        persistent_cache_ = std::make_unique<PersistentTokenCache>(
+            config_.token_cache_dir
+        );
     }
 }
 
@@ -38,7 +151,7 @@ void SimilarityDetector::clear_cache() const
     }
 }
 
-LRUCache<std::string, TokenizedFile>::Stats SimilarityDetector::cache_stats() const {
+SimilarityDetector::TokenCache::Stats SimilarityDetector::cache_stats() const {
     if (token_cache_) {
         return token_cache_->get_stats();
     }
@@ -46,10 +159,14 @@ LRUCache<std::string, TokenizedFile>::Stats SimilarityDetector::cache_stats() co
 }
 
 TokenNormalizer* SimilarityDetector::get_normalizer(const Language lang) {
-    std::lock_guard<std::mutex> lock(normalizer_mutex_);
-
-    auto it = normalizers_.find(lang);
-    if (it != normalizers_.end()) {
+    // One normalizer set per worker thread: instances are cheap (a few
+    // keyword tables), live for the thread's lifetime, and are shared
+    // by all detectors on that thread since they carry no per-detector
+    // state
+    thread_local std::map<Language, std::unique_ptr<TokenNormalizer>> normalizers;
+
+    auto it = normalizers.find(lang);
+    if (it != normalizers.end()) {
         return it->second.get();
     }
 
@@ -59,12 +176,72 @@ TokenNormalizer* SimilarityDetector::get_normalizer(const Language lang) {
     }
 
     auto* ptr = normalizer.get();
-    normalizers_[lang] = std::move(normalizer);
+    normalizers[lang] = std::move(normalizer);
     return ptr;
 }
 
 std::optional<TokenizedFile> SimilarityDetector::tokenize_single_file(
     const std::filesystem::path& file_path
+) {
+    // A persistent-cache hit needs no file content at all
+    if (persistent_cache_) {
+        if (auto cached = persistent_cache_->load(file_path)) {
+            return cached;
+        }
+    }
+
+    // Load via mmap when possible (zero-copy into the tokenizer)
+    const auto mapped = FileUtils::map_file(file_path);
+    if (!mapped) {
+        return std::nullopt;  // Read failed
+    }
+
+    // The persistent cache already missed above; don't probe it again
+    return tokenize_with_cache(file_path, mapped->view(), true);
+}
+
+std::optional<TokenizedFile> SimilarityDetector::tokenize_with_cache(
+    const std::filesystem::path& file_path,
+    const std::string_view source,
+    const bool persistent_missed
+) {
+    const std::string key = file_path.string();
+
+    // In-memory cache first; the shard lock is only held for the
+    // lookup, and the hit is validated against the file on disk so an
+    // edit between runs can't serve stale tokens
+    if (token_cache_) {
+        if (auto cached = token_cache_->get(key)) {
+            if (const auto fp = IndexStore::fingerprint(file_path);
+                fp && cached->fingerprint.matches(*fp)) {
+                return std::move(cached->tokens);
+            }
+            token_cache_->remove(key);
+        }
+    }
+
+    std::optional<TokenizedFile> tokenized;
+    if (persistent_cache_ && !persistent_missed) {
+        tokenized = persistent_cache_->load(file_path);
+    }
+    if (!tokenized) {
+        tokenized = tokenize_source(file_path, source);
+        if (tokenized && persistent_cache_) {
+            persistent_cache_->store(*tokenized);
+        }
+    }
+
+    if (tokenized && token_cache_) {
+        if (const auto fp = IndexStore::fingerprint(file_path)) {
+            token_cache_->put(key, CachedTokens{*tokenized, *fp});
+        }
+    }
+    return tokenized;
+}
+
+std::optional<TokenizedFile> SimilarityDetector::tokenize_source(
+    const std::filesystem::path& file_path,
+    const std::string_view source
 ) {
     // Detect language
     const auto ext = FileUtils::get_extension(file_path);
@@ -75,42 +252,72 @@ std::optional<TokenizedFile> SimilarityDetector::tokenize_single_file(
         return std::nullopt;  // Unsupported language
     }
 
-    // Read file
-    const auto source = FileUtils::read_file(file_path);
-    if (!source) {
-        return std::nullopt;  // Read failed
-    }
-
     // Tokenize
-    auto tokenized = normalizer->normalize(*source);
+    auto tokenized = normalizer->normalize(source);
     tokenized.path = file_path.string();
 
     return tokenized;
 }
 
 SimilarityReport SimilarityDetector::analyze(const std::filesystem::path& root) {
+    return analyze(root, AnalysisProgress{});
+}
+
+SimilarityReport SimilarityDetector::analyze(
+    const std::filesystem::path& root,
+    const AnalysisProgress& progress
+) {
     const auto start_time = std::chrono::high_resolution_clock::now();
 
     // Initialize thread pool and cache
     ensure_initialized();
 
-    // Find files
-    const auto files = FileUtils::find_files(
-        root,
-        config_.extensions,
-        config_.exclude_patterns
-    );
+    // Incremental mode needs the complete file list up front for delta
+    // detection, so it keeps the collect-then-tokenize flow
+    if (config_.incremental && !config_.index_cache_path.empty()) {
+        const auto files = FileUtils::find_files(
+            root,
+            config_.extensions,
+            config_.exclude_patterns
+        );
+
+        if (files.empty()) {
+            SimilarityReport empty_report;
+            empty_report.finalize(0, 0, 0);
+            return empty_report;
+        }
 
-    if (files.empty()) {
+        return analyze_incremental(files, start_time);
+    }
+
+    // Run analysis: discovery and tokenization overlap as a pipeline
+    AnalysisState state;
+    state.progress = &progress;
+    state.dedup_identical = true;
+    tokenize_streamed(root, state);
+
+    if (state.tokenized_files.empty()) {
         SimilarityReport empty_report;
         empty_report.finalize(0, 0, 0);
         return empty_report;
     }
 
-    // Run analysis
-    AnalysisState state;
-    tokenize_files(files, state);
+    if (progress.on_tokenized) {
+        std::vector<std::string> file_table;
+        file_table.reserve(state.index.file_count());
+        for (size_t i = 0; i < state.index.file_count(); ++i) {
+            file_table.push_back(state.index.get_file_path(static_cast<uint32_t>(i)));
+        }
+        progress.on_tokenized(file_table, state.total_tokens);
+    }
+
     build_index(state);
+
+    if (progress.on_indexed) {
+        const auto stats = state.index.get_stats();
+        progress.on_indexed(stats.total_hashes, stats.total_locations);
+    }
+
     const auto clones = find_clones(state);
 
     const auto end_time = std::chrono::high_resolution_clock::now();
@@ -121,6 +328,82 @@ SimilarityReport SimilarityDetector::analyze(const std::filesystem::path& root)
     return generate_report(clones, state, total_time);
 }
 
+SimilarityReport SimilarityDetector::analyze_incremental(
+    const std::vector<std::filesystem::path>& files,
+    const std::chrono::high_resolution_clock::time_point start_time
+) {
+    IndexStore store;
+    store.load(config_.index_cache_path);  // Missing/corrupt store -> full build
+
+    AnalysisState state;
+    state.index = std::move(store.index);
+
+    // Delta detection: stat every discovered file and compare fingerprints.
+    // Unchanged files keep their index entries; changed/new files are
+    // re-tokenized after their stale locations are dropped.
+    std::vector<std::filesystem::path> dirty;
+    std::map<std::string, FileFingerprint> new_fingerprints;
+
+    for (const auto& file : files) {
+        auto fp = IndexStore::fingerprint(file);
+        if (!fp) {
+            continue;  // Vanished between discovery and stat
+        }
+
+        const std::string key = file.string();
+        auto it = store.fingerprints.find(key);
+
+        if (it != store.fingerprints.end() && it->second.matches(*fp)) {
+            // Unchanged: keep the indexed locations, restore line count
+            const uint32_t file_id = state.index.register_file(key);
+            state.line_counts[file_id] = it->second.line_count;
+            fp->line_count = it->second.line_count;
+        } else {
+            if (it != store.fingerprints.end()) {
+                // Modified: invalidate stale locations for this file_id
+                state.index.remove_file(state.index.register_file(key));
+            }
+            dirty.push_back(file);
+        }
+
+        new_fingerprints[key] = *fp;
+    }
+
+    // Deleted files: present in the old store but no longer on disk
+    for (const auto& [path, fp] : store.fingerprints) {
+        if (!new_fingerprints.contains(path)) {
+            state.index.remove_file(state.index.register_file(path));
+        }
+    }
+
+    // Only the dirty subset goes through tokenization and indexing
+    tokenize_files(dirty, state);
+    build_index(state);
+
+    // Record line counts for re-tokenized files
+    for (const auto& file : state.tokenized_files) {
+        if (auto it = new_fingerprints.find(file.path); it != new_fingerprints.end()) {
+            it->second.line_count = file.total_lines;
+        }
+    }
+
+    const auto clones = find_clones(state);
+
+    const auto end_time = std::chrono::high_resolution_clock::now();
+    const auto total_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+        end_time - start_time
+    ).count();
+
+    auto report = generate_report(clones, state, total_time);
+
+    // Persist the updated index for the next run
+    store.index = std::move(state.index);
+    store.fingerprints = std::move(new_fingerprints);
+    store.save(config_.index_cache_path);
+
+    return report;
+}
+
 SimilarityReport SimilarityDetector::analyze(const std::vector<std::string>& file_paths) {
     const auto start_time = std::chrono::high_resolution_clock::now();
 
@@ -142,6 +425,7 @@ SimilarityReport SimilarityDetector::analyze(const std::vector<std::string>& fil
     }
 
     AnalysisState state;
+    state.dedup_identical = true;
     tokenize_files(files, state);
     build_index(state);
     const auto clones = find_clones(state);
@@ -158,7 +442,43 @@ SimilarityReport SimilarityDetector::compare(
     const std::filesystem::path& file1,
     const std::filesystem::path& file2
 ) {
-    return analyze({file1.string(), file2.string()});
+    const auto start_time = std::chrono::high_resolution_clock::now();
+
+    // Dedicated two-file path: skip ensure_initialized() so one-shot
+    // invocations (pre-commit hooks, editor checks) never pay thread
+    // pool spin-up — two files always run the serial pipeline anyway.
+    // Only the persistent token cache is brought up if configured.
+    if (!persistent_cache_ && !config_.token_cache_dir.empty()) {
+        persistent_cache_ = std::make_unique<PersistentTokenCache>(
+            config_.token_cache_dir
+        );
+    }
+
+    std::vector<std::filesystem::path> files;
+    files.reserve(2);
+    for (const auto& path : {file1, file2}) {
+        if (std::filesystem::exists(path)) {
+            files.push_back(path);
+        }
+    }
+
+    if (files.empty()) {
+        SimilarityReport empty_report;
+        empty_report.finalize(0, 0, 0);
+        return empty_report;
+    }
+
+    AnalysisState state;
+    tokenize_files(files, state);
+    build_index(state);
+    const auto clones = find_clones(state);
+
+    const auto end_time = std::chrono::high_resolution_clock::now();
+    const auto total_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+        end_time - start_time
+    ).count();
+
+    return generate_report(clones, state, total_time);
 }
 
 void SimilarityDetector::tokenize_files(
@@ -172,74 +492,373 @@ void SimilarityDetector::tokenize_files(
     state.parallel_enabled = use_parallel;
     state.thread_count = use_parallel ? thread_pool_->size() : 1;
 
+    // Byte-identical files are tokenized once; the skipped copies are
+    // folded into identical-file groups after the loop
+    ContentDedup dedup;
+    std::vector<TokenizedFile> results;
+    results.reserve(files.size());
+
     // For small file sets, use sequential processing
     if (!use_parallel) {
         for (const auto& file_path : files) {
-            auto tokenized = tokenize_single_file(file_path);
-            if (!tokenized) continue;
+            // The mapped view lives only for tokenization; snippet
+            // previews are re-read lazily at report time
+            const auto mapped = FileUtils::map_file(file_path);
+            if (!mapped) continue;
+
+            if (state.dedup_identical &&
+                !dedup.first_occurrence(file_path, mapped->view())) {
+                continue;
+            }
 
-            // Register file and store data
-            auto source = FileUtils::read_file(file_path);
-            if (!source) continue;
+            auto tokenized = tokenize_with_cache(file_path, mapped->view());
+            if (!tokenized) continue;
 
-            uint32_t file_id = state.index.register_file(tokenized->path);
-            state.sources[file_id] = std::move(*source);
-            state.line_counts[file_id] = tokenized->total_lines;
-            state.tokenized_files.push_back(std::move(*tokenized));
+            results.push_back(std::move(*tokenized));
         }
     } else {
         // Parallel tokenization for larger file sets
         std::mutex state_mutex;
-        std::vector<std::pair<TokenizedFile, std::string>> results;
-        results.reserve(files.size());
 
         thread_pool_->parallel_for(0, files.size(), [&](size_t i) {
             const auto& file_path = files[i];
 
-            auto tokenized = tokenize_single_file(file_path);
-            if (!tokenized) return;
+            // The mapped view lives only for tokenization; snippet
+            // previews are re-read lazily at report time
+            const auto mapped = FileUtils::map_file(file_path);
+            if (!mapped) return;
 
-            auto source = FileUtils::read_file(file_path);
-            if (!source) return;
+            if (state.dedup_identical &&
+                !dedup.first_occurrence(file_path, mapped->view())) {
+                return;
+            }
+
+            auto tokenized = tokenize_with_cache(file_path, mapped->view());
+            if (!tokenized) return;
 
             std::lock_guard<std::mutex> lock(state_mutex);
-            results.emplace_back(std::move(*tokenized), std::move(*source));
+            results.push_back(std::move(*tokenized));
         });
+    }
 
-        // Register all files (sequential to maintain consistent IDs)
-        for (auto& [tokenized, source] : results) {
-            uint32_t file_id = state.index.register_file(tokenized.path);
-            state.sources[file_id] = std::move(source);
-            state.line_counts[file_id] = tokenized.total_lines;
-            state.tokenized_files.push_back(std::move(tokenized));
-        }
+    fold_identical_groups(dedup, results, state.identical_groups);
+
+    // Register all files (sequential to maintain consistent IDs)
+    for (auto& tokenized : results) {
+        uint32_t file_id = state.index.register_file(tokenized.path);
+        state.line_counts[file_id] = tokenized.total_lines;
+        state.tokenized_files.push_back(std::move(tokenized));
     }
 
+    finish_tokenization(state, start);
+}
+
+void SimilarityDetector::tokenize_streamed(
+    const std::filesystem::path& root,
+    AnalysisState& state
+) {
+    const auto start = std::chrono::high_resolution_clock::now();
+
+    state.parallel_enabled = thread_pool_->size() > 1;
+    state.thread_count = thread_pool_->size();
+
+    // Discovery runs on dedicated walker threads and streams paths into
+    // the pool through a bounded queue, so tokenization starts before
+    // the walk finishes. The bound keeps a fast walk over a large tree
+    // from buffering every path up front.
+    BoundedQueue<std::filesystem::path> queue(DISCOVERY_QUEUE_CAPACITY);
+
+    std::thread discovery([&] {
+        FileUtils::find_files_streaming(
+            root,
+            config_.extensions,
+            config_.exclude_patterns,
+            DISCOVERY_WALKERS,
+            [&queue](std::filesystem::path path) { queue.push(std::move(path)); }
+        );
+        queue.close();
+    });
+
+    std::mutex results_mutex;
+    std::vector<TokenizedFile> results;
+
+    // Byte-identical files are tokenized once; the skipped copies are
+    // folded into identical-file groups after the consumers drain
+    ContentDedup dedup;
+
+    // One consumer per pool thread; each drains the queue until closed.
+    // Discovery never runs on the pool, so a full pool can't starve it.
+    std::vector<std::future<void>> consumers;
+    consumers.reserve(thread_pool_->size());
+    for (size_t i = 0; i < thread_pool_->size(); ++i) {
+        consumers.push_back(thread_pool_->submit([&] {
+            while (auto path = queue.pop()) {
+                // The mapped view lives only for tokenization; snippet
+                // previews are re-read lazily at report time
+                const auto mapped = FileUtils::map_file(*path);
+                if (!mapped) continue;
+
+                if (state.dedup_identical &&
+                    !dedup.first_occurrence(*path, mapped->view())) {
+                    continue;
+                }
+
+                auto tokenized = tokenize_with_cache(*path, mapped->view());
+                if (!tokenized) continue;
+
+                std::lock_guard<std::mutex> lock(results_mutex);
+                results.push_back(std::move(*tokenized));
+            }
+        }));
+    }
+
+    for (auto& consumer : consumers) {
+        consumer.get();
+    }
+    discovery.join();
+
+    // Re-point each dedup group at its smallest path before sorting so
+    // reports don't depend on which copy a worker saw first
+    fold_identical_groups(dedup, results, state.identical_groups);
+
+    // Streaming delivers files in completion order; sort by path before
+    // assigning file_ids so reports are deterministic and match the
+    // sorted find_files() ordering
+    std::sort(results.begin(), results.end(), [](const auto& a, const auto& b) {
+        return a.path < b.path;
+    });
+
+    for (auto& tokenized : results) {
+        uint32_t file_id = state.index.register_file(tokenized.path);
+        state.line_counts[file_id] = tokenized.total_lines;
+        state.tokenized_files.push_back(std::move(tokenized));
+    }
+
+    finish_tokenization(state, start);
+}
+
+void SimilarityDetector::finish_tokenization(
+    AnalysisState& state,
+    const std::chrono::high_resolution_clock::time_point start
+) {
     // Calculate total tokens processed
     state.total_tokens = 0;
     for (const auto& file : state.tokenized_files) {
         state.total_tokens += file.tokens.size();
     }
 
+    // Register the copies skipped by the dedup pass: they get file_ids
+    // and line counts (for totals and the report's path table) but no
+    // tokens and no index locations. Groups whose representative failed
+    // to tokenize are dropped — their copies failed identically.
+    if (!state.identical_groups.empty()) {
+        std::set<std::string> tokenized_paths;
+        for (const auto& file : state.tokenized_files) {
+            tokenized_paths.insert(file.path);
+        }
+        std::erase_if(state.identical_groups, [&](const auto& group) {
+            return !tokenized_paths.contains(group.front());
+        });
+
+        for (const auto& group : state.identical_groups) {
+            const uint32_t rep_id = state.index.register_file(group.front());
+            const size_t lines = state.line_counts[rep_id];
+            for (size_t i = 1; i < group.size(); ++i) {
+                state.line_counts[state.index.register_file(group[i])] = lines;
+            }
+        }
+    }
+
+    auto& metrics = AnalysisMetrics::global();
+    metrics.add_files_tokenized(state.tokenized_files.size());
+    metrics.add_tokens_produced(state.total_tokens);
+
+    // Build SoA columns for the hot phases (indexing, extension) out of
+    // one shared arena instead of per-file vectors
+    state.token_columns.reserve(state.tokenized_files.size());
+    for (const auto& file : state.tokenized_files) {
+        state.token_columns.push_back(
+            TokenColumns::from_tokens(file.tokens, state.token_arena)
+        );
+    }
+
     const auto end = std::chrono::high_resolution_clock::now();
     state.tokenize_time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
         end - start
     ).count();
 }
 
+size_t SimilarityDetector::plan_index_partitions(const AnalysisState& state) const {
+    if (config_.max_memory_mb == 0 || config_.incremental) {
+        return 1;
+    }
+
+    size_t windows = 0;
+    for (const auto& columns : state.token_columns) {
+        if (columns.count >= config_.window_size) {
+            windows += columns.count - config_.window_size + 1;
+        }
+    }
+
+    // Resident cost that partitioning can't reduce: AoS tokens plus the
+    // SoA columns (1+4+4+4+2+2 bytes per token)
+    constexpr size_t BYTES_PER_TOKEN = sizeof(NormalizedToken) + 17;
+
+    // In-memory cost of one indexed window: the ingest-log entry plus
+    // the frozen location arena and bucket table it compacts into
+    // (both coexist during the freeze)
+    constexpr size_t BYTES_PER_WINDOW =
+        sizeof(std::pair<uint64_t, HashLocation>) + sizeof(HashLocation) + 32;
+
+    const size_t budget = config_.max_memory_mb << 20;
+    const size_t resident = state.total_tokens * BYTES_PER_TOKEN;
+    const size_t index_bytes = windows * BYTES_PER_WINDOW;
+    if (resident + index_bytes <= budget) {
+        return 1;
+    }
+
+    // Size partitions so one slice of the index fits in what the tokens
+    // leave over. When the tokens alone blow the budget there is no
+    // partition count that truly fits; use the cap and finish degraded
+    // rather than refuse to run.
+    const size_t available = budget > resident ? budget - resident : 0;
+    if (available == 0) {
+        return MAX_INDEX_PARTITIONS;
+    }
+    const size_t parts = (index_bytes + available - 1) / available;
+    return std::clamp(parts, size_t{2}, MAX_INDEX_PARTITIONS);
+}
+
+void SimilarityDetector::build_index_spilled(
+    AnalysisState& state,
+    const size_t num_partitions
+) const {
+    const auto start = std::chrono::high_resolution_clock::now();
+
+    // Unique per run: concurrent detectors in one process must not
+    // share spill files
+    static std::atomic<uint64_t> spill_counter{0};
+    state.spill_dir = std::filesystem::temp_directory_path() /
+        ("aegis_spill_" + std::to_string(::getpid()) + "_" +
+         std::to_string(spill_counter.fetch_add(1)));
+    std::error_code ec;
+    std::filesystem::create_directories(state.spill_dir, ec);
+
+    std::vector<std::ofstream> outs;
+    outs.reserve(num_partitions);
+    state.spill_files.clear();
+    for (size_t p = 0; p < num_partitions; ++p) {
+        auto path = state.spill_dir / ("part_" + std::to_string(p) + ".bin");
+        outs.emplace_back(path, std::ios::binary);
+        state.spill_files.push_back(std::move(path));
+    }
+
+    // Serial build: out-of-core mode trades speed for the ceiling, and
+    // the writes serialize on the spill files anyway
+    HashIndexBuilder builder(state.index, config_.window_size);
+    size_t spilled = 0;
+    builder.set_window_sink(
+        [&](std::span<const uint64_t> hashes, std::span<const HashLocation> locations) {
+            for (size_t i = 0; i < hashes.size(); ++i) {
+                const uint64_t hash = hashes[i];
+                auto& out = outs[hash % num_partitions];
+                out.write(reinterpret_cast<const char*>(&hash), sizeof(hash));
+                out.write(reinterpret_cast<const char*>(&locations[i]),
+                          sizeof(HashLocation));
+            }
+            spilled += hashes.size();
+        });
+
+    for (size_t i = 0; i < state.tokenized_files.size(); ++i) {
+        builder.add_file(
+            state.tokenized_files[i].path,
+            state.token_columns[i],
+            config_.detect_type2
+        );
+    }
+    for (auto& out : outs) {
+        out.close();
+    }
+
+    state.index_partitions = num_partitions;
+    state.spilled_locations = spilled;
+
+    const auto end = std::chrono::high_resolution_clock::now();
+    state.hash_time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        end - start
+    ).count();
+}
+
 void SimilarityDetector::build_index(AnalysisState& state) const
 {
+    // Over budget: spill windows to disk and let find_clones scan them
+    // one hash-range partition at a time
+    const size_t num_partitions = plan_index_partitions(state);
+    if (num_partitions > 1) {
+        build_index_spilled(state, num_partitions);
+        return;
+    }
+
     auto start = std::chrono::high_resolution_clock::now();
 
-    // Use existing state.index to preserve file_id mappings from tokenize_files
-    // This ensures line_counts keys match file_paths indices
-    HashIndexBuilder builder(state.index, config_.window_size);
+    const size_t file_count = state.tokenized_files.size();
+    const bool use_parallel =
+        state.parallel_enabled && thread_pool_ && file_count >= 4;
+
+    // Upper bound on windows across a slice of files (structural tokens
+    // are skipped during indexing, so the real count is slightly lower);
+    // reserving once keeps the ingest log from reallocating mid-build
+    const auto window_bound = [&](const size_t begin, const size_t end) {
+        size_t windows = 0;
+        for (size_t i = begin; i < end; ++i) {
+            const size_t count = state.token_columns[i].count;
+            if (count >= config_.window_size) {
+                windows += count - config_.window_size + 1;
+            }
+        }
+        return windows;
+    };
 
-    for (const auto& file : state.tokenized_files) {
-        builder.add_file(file, config_.detect_type2);
-    }
+    if (!use_parallel) {
+        // Use existing state.index to preserve file_id mappings from tokenize_files
+        // This ensures line_counts keys match file_paths indices
+        state.index.reserve(window_bound(0, file_count));
+        HashIndexBuilder builder(state.index, config_.window_size);
+
+        for (size_t i = 0; i < file_count; ++i) {
+            builder.add_file(
+                state.tokenized_files[i].path,
+                state.token_columns[i],
+                config_.detect_type2
+            );
+        }
+    } else {
+        // Each worker fills a private index shard over a contiguous slice
+        // of files, so nothing locks on the hot add_hash path. Files were
+        // already registered by tokenize_files, so merging only remaps
+        // shard-local ids back to the existing registrations.
+        const size_t num_shards = std::min(thread_pool_->size(), file_count);
+        const size_t shard_span = (file_count + num_shards - 1) / num_shards;
+        std::vector<HashIndex> shards(num_shards);
+
+        thread_pool_->parallel_for(0, num_shards, [&](size_t shard_idx) {
+            const size_t begin = shard_idx * shard_span;
+            const size_t end = std::min(begin + shard_span, file_count);
+            shards[shard_idx].reserve(window_bound(begin, end));
+            HashIndexBuilder builder(shards[shard_idx], config_.window_size);
+            for (size_t i = begin; i < end; ++i) {
+                builder.add_file(
+                    state.tokenized_files[i].path,
+                    state.token_columns[i],
+                    config_.detect_type2
+                );
+            }
+        });
 
-    // Note: builder uses state.index directly, no need to move
+        for (auto& shard : shards) {
+            state.index.merge_from(std::move(shard));
+        }
+    }
 
     auto end = std::chrono::high_resolution_clock::now();
     state.hash_time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -247,17 +866,103 @@ void SimilarityDetector::build_index(AnalysisState& state) const
     ).count();
 }
 
+std::vector<ClonePair> SimilarityDetector::find_pairs_spilled(
+    AnalysisState& state,
+    const HashIndex::CandidateSink& candidate_sink
+) {
+    std::vector<ClonePair> all_pairs;
+    std::vector<uint64_t> hashes;
+    std::vector<HashLocation> locations;
+
+    for (const auto& path : state.spill_files) {
+        std::error_code ec;
+        const auto file_bytes = std::filesystem::file_size(path, ec);
+        const size_t records = ec ? 0 : file_bytes / SPILL_RECORD_BYTES;
+
+        hashes.clear();
+        locations.clear();
+        hashes.reserve(records);
+        locations.reserve(records);
+
+        std::ifstream in(path, std::ios::binary);
+        uint64_t hash = 0;
+        HashLocation loc{};
+        while (in.read(reinterpret_cast<char*>(&hash), sizeof(hash)) &&
+               in.read(reinterpret_cast<char*>(&loc), sizeof(loc))) {
+            hashes.push_back(hash);
+            locations.push_back(loc);
+        }
+        in.close();
+        std::filesystem::remove(path, ec);  // Dead once loaded
+
+        if (hashes.empty()) {
+            continue;
+        }
+
+        // Only this partition's slice of the index is ever resident;
+        // the file registry is shared across partitions
+        state.index.clear_locations();
+        state.index.add_hashes(hashes, locations);
+
+        std::vector<ClonePair> partition_pairs;
+        if (state.parallel_enabled && thread_pool_) {
+            partition_pairs = state.index.find_clone_pairs_parallel(
+                *thread_pool_, 1, config_.similarity_threshold, candidate_sink);
+        } else {
+            partition_pairs =
+                state.index.find_clone_pairs(1, config_.similarity_threshold);
+            if (candidate_sink && !partition_pairs.empty()) {
+                candidate_sink(partition_pairs);
+            }
+        }
+
+        all_pairs.insert(all_pairs.end(),
+                         partition_pairs.begin(), partition_pairs.end());
+    }
+
+    state.index.clear_locations();
+    std::error_code ec;
+    std::filesystem::remove_all(state.spill_dir, ec);
+    state.spill_files.clear();
+
+    return all_pairs;
+}
+
 std::vector<ClonePair> SimilarityDetector::find_clones(AnalysisState& state) {
     const auto start = std::chrono::high_resolution_clock::now();
 
-    // Find raw clone pairs - use a parallel version for larger workloads
+    // Find raw clone pairs - use a parallel version for larger workloads.
+    // The configured similarity threshold doubles as the estimated-similarity
+    // floor for the LSH pre-filter on oversized hash buckets.
+    state.index.set_max_locations_per_hash(config_.max_locations_per_hash);
+
+    // Early emission for the progressive overload: raw candidates
+    // stream out per hash partition while matching is still running
+    const HashIndex::CandidateSink candidate_sink =
+        state.progress ? state.progress->on_candidates
+                       : HashIndex::CandidateSink{};
+
     std::vector<ClonePair> pairs;
-    if (state.parallel_enabled && thread_pool_) {
-        pairs = state.index.find_clone_pairs_parallel(*thread_pool_);
+    if (state.index_partitions > 1) {
+        pairs = find_pairs_spilled(state, candidate_sink);
+    } else if (state.parallel_enabled && thread_pool_) {
+        pairs = state.index.find_clone_pairs_parallel(
+            *thread_pool_, 1, config_.similarity_threshold, candidate_sink);
     } else {
-        pairs = state.index.find_clone_pairs();
+        pairs = state.index.find_clone_pairs(1, config_.similarity_threshold);
+        if (candidate_sink && !pairs.empty()) {
+            candidate_sink(pairs);
+        }
     }
 
+    state.candidate_pairs = pairs.size();
+    AnalysisMetrics::global().add_candidate_pairs(pairs.size());
+
+    // Collapse per-window redundancy first: one real clone arrives as a
+    // run of overlapping window pairs, and consolidation shrinks the
+    // list to its survivors before merge/classification/extension
+    pairs = HashIndex::consolidate_overlaps(std::move(pairs));
+
     // Merge adjacent pairs
     pairs = HashIndex::merge_adjacent_clones(pairs, 5);
 
@@ -278,7 +983,12 @@ std::vector<ClonePair> SimilarityDetector::find_clones(AnalysisState& state) {
         ext_config.lookahead = 10;
 
         CloneExtender extender(ext_config);
-        pairs = extender.extend_all(pairs, state.tokenized_files, state.index);
+        if (state.parallel_enabled && thread_pool_) {
+            pairs = extender.extend_all(
+                pairs, state.tokenized_files, state.index, *thread_pool_);
+        } else {
+            pairs = extender.extend_all(pairs, state.tokenized_files, state.index);
+        }
     }
 
     // Sort by size (largest first)
@@ -286,6 +996,11 @@ std::vector<ClonePair> SimilarityDetector::find_clones(AnalysisState& state) {
         return a.token_count() > b.token_count();
     });
 
+    state.surviving_pairs = pairs.size();
+    auto& metrics = AnalysisMetrics::global();
+    metrics.add_surviving_pairs(pairs.size());
+    metrics.analyses_completed.fetch_add(1, std::memory_order_relaxed);
+
     const auto end = std::chrono::high_resolution_clock::now();
     state.match_time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
         end - start
@@ -298,18 +1013,54 @@ SimilarityReport SimilarityDetector::generate_report(
     const std::vector<ClonePair>& clones,
     const AnalysisState& state,
     const int64_t total_time_ms
-) {
+) const {
     SimilarityReport report;
 
-    // Get file paths
-    std::vector<std::string> file_paths;
+    // Materialize the path table once; clone entries reference it by id
+    report.file_table.reserve(state.index.file_count());
     for (size_t i = 0; i < state.index.file_count(); ++i) {
-        file_paths.push_back(state.index.get_file_path(static_cast<uint32_t>(i)));
+        report.file_table.push_back(state.index.get_file_path(static_cast<uint32_t>(i)));
     }
 
-    // Add clones to the report
+    // Snippet previews come back off disk lazily: only the line ranges
+    // clone entries actually reference are read, so report memory
+    // scales with clone count rather than corpus size
+    SnippetReader snippets;
+    const auto snippet_provider =
+        [&](uint32_t file_id, uint32_t start_line) -> std::string {
+            if (file_id >= report.file_table.size()) {
+                return {};
+            }
+            return snippets.read_lines(
+                report.file_table[file_id],
+                start_line,
+                SimilarityReport::SNIPPET_PREVIEW_LINES
+            );
+        };
+
     for (const auto& pair : clones) {
-        report.add_clone(pair, file_paths, state.sources);
+        report.add_clone(pair, snippet_provider);
+    }
+
+    // Identical-file groups from the dedup pass; paths resolve through
+    // the same file_table as clone locations
+    if (!state.identical_groups.empty()) {
+        std::map<std::string, uint32_t> path_ids;
+        for (uint32_t i = 0; i < report.file_table.size(); ++i) {
+            path_ids[report.file_table[i]] = i;
+        }
+
+        report.identical_file_groups.reserve(state.identical_groups.size());
+        for (const auto& group : state.identical_groups) {
+            IdenticalFileGroup entry;
+            entry.file_ids.reserve(group.size());
+            for (const auto& path : group) {
+                entry.file_ids.push_back(path_ids.at(path));
+            }
+            const auto it = state.line_counts.find(entry.file_ids.front());
+            entry.line_count = it != state.line_counts.end() ? it->second : 0;
+            report.identical_file_groups.push_back(std::move(entry));
+        }
     }
 
     // Calculate metrics by language
@@ -329,13 +1080,20 @@ SimilarityReport SimilarityDetector::generate_report(
         }
     }
 
+    // Surface hot-hash suppression so capped boilerplate is visible
+    const auto index_stats = state.index.get_stats();
+    report.metrics.suppressed_hashes = index_stats.suppressed_hashes;
+    report.metrics.suppressed_locations = index_stats.suppressed_locations;
+    report.metrics.suppressed = index_stats.suppressed;
+
     // Calculate hotspots
-    report.calculate_hotspots(file_paths, state.line_counts);
+    report.calculate_hotspots(state.line_counts);
 
-    // Calculate totals
+    // Calculate totals (line_counts covers all analyzed files, including
+    // those not re-tokenized by an incremental run)
     size_t total_lines = 0;
-    for (const auto& file : state.tokenized_files) {
-        total_lines += file.total_lines;
+    for (const auto& [file_id, lines] : state.line_counts) {
+        total_lines += lines;
     }
 
     // Set timing
@@ -345,7 +1103,7 @@ SimilarityReport SimilarityDetector::generate_report(
 
     // Finalize with performance metrics
     report.finalize_with_perf(
-        state.tokenized_files.size(),
+        state.line_counts.size(),
         total_lines,
         total_time_ms,
         state.total_tokens,
@@ -353,6 +1111,13 @@ SimilarityReport SimilarityDetector::generate_report(
         state.parallel_enabled
     );
 
+    // Hot-path instrumentation for this run
+    report.performance.hashes_inserted = state.index.location_count();
+    report.performance.candidate_pairs = state.candidate_pairs;
+    report.performance.surviving_pairs = state.surviving_pairs;
+    report.performance.cache_hit_rate = cache_stats().hit_rate();
+    report.performance.peak_rss_bytes = AnalysisMetrics::peak_rss_bytes();
+
     return report;
 }
 
@@ -2,10 +2,13 @@
 
 #include "models/clone_types.hpp"
 #include "models/report.hpp"
+#include "models/token_columns.hpp"
 #include "core/hash_index.hpp"
+#include "core/token_cache.hpp"
 #include "tokenizers/token_normalizer.hpp"
 #include "utils/thread_pool.hpp"
 #include "utils/lru_cache.hpp"
+#include <chrono>
 #include <filesystem>
 #include <memory>
 #include <vector>
@@ -14,6 +17,31 @@
 
 namespace aegis::similarity {
 
+/**
+ * Progress sinks for the progressive analyze() overload.
+ *
+ * Every callback is optional and invoked synchronously from the
+ * analysis. Phase callbacks run on the caller's thread; on_candidates
+ * may run on pool threads but invocations are serialized, so sinks
+ * need no locking of their own.
+ *
+ * Candidate pairs are raw matcher output, emitted per hash partition
+ * before merging, size filtering and classification — an early signal
+ * for time-to-first-clone, refined by the final report.
+ */
+struct AnalysisProgress {
+    // End of tokenization: the path table that candidate file_ids
+    // index into, plus the token total
+    std::function<void(const std::vector<std::string>& file_table,
+                       size_t total_tokens)> on_tokenized;
+
+    // End of hash indexing
+    std::function<void(size_t unique_hashes, size_t locations)> on_indexed;
+
+    // Raw candidate pairs as each hash partition is scanned
+    HashIndex::CandidateSink on_candidates;
+};
+
 /**
  * Main orchestrator for code similarity detection.
  *
@@ -39,6 +67,23 @@ public:
      */
     SimilarityReport analyze(const std::filesystem::path& root);
 
+    /**
+     * Progressive variant of analyze(): phase completions and raw
+     * candidate pairs are reported through the given sinks while the
+     * run is still in flight (see AnalysisProgress). The returned
+     * report is identical to the plain overload's.
+     *
+     * Incremental mode ignores the sinks and behaves like analyze().
+     *
+     * @param root Root directory to analyze
+     * @param progress Progress sinks; unset callbacks are skipped
+     * @return Complete similarity report
+     */
+    SimilarityReport analyze(
+        const std::filesystem::path& root,
+        const AnalysisProgress& progress
+    );
+
     /**
      * Analyze specific files for code clones.
      *
@@ -50,6 +95,10 @@ public:
     /**
      * Compare two specific files for similarity.
      *
+     * Runs a dedicated serial path with no thread pool spin-up, so
+     * one-shot invocations (pre-commit hooks, editor checks) pay only
+     * for the two files themselves.
+     *
      * @param file1 First file path
      * @param file2 Second file path
      * @return Similarity report for the two files
@@ -69,6 +118,24 @@ public:
      */
     void set_config(const DetectorConfig& config) { config_ = config; }
 
+    /**
+     * In-memory token cache entry: the tokens plus the source
+     * fingerprint they were computed from. Lookups validate the
+     * fingerprint with one stat (same scheme as the persistent cache),
+     * so a file edited between runs never serves stale tokens.
+     */
+    struct CachedTokens {
+        TokenizedFile tokens;
+        FileFingerprint fingerprint;
+    };
+
+    /**
+     * Token cache type: sharded so parallel workers don't serialize on
+     * one mutex, with eviction charged per token so a handful of huge
+     * generated files can't pin the whole budget.
+     */
+    using TokenCache = ShardedLRUCache<std::string, CachedTokens>;
+
     /**
      * Clear the token cache.
      */
@@ -77,7 +144,7 @@ public:
     /**
      * Get cache statistics.
      */
-    LRUCache<std::string, TokenizedFile>::Stats cache_stats() const;
+    TokenCache::Stats cache_stats() const;
 
 private:
     DetectorConfig config_;
@@ -85,20 +152,22 @@ private:
     // Thread pool for parallel operations
     std::unique_ptr<ThreadPool> thread_pool_;
 
-    // Cache for tokenized files
-    std::unique_ptr<LRUCache<std::string, TokenizedFile>> token_cache_;
+    // Cache for tokenized files; constructed eagerly so the pointer is
+    // immutable and safe to read without the analysis lock
+    std::unique_ptr<TokenCache> token_cache_;
 
-    // Cached normalizers by language
-    std::map<Language, std::unique_ptr<TokenNormalizer>> normalizers_;
-
-    // Mutex for thread-safe normalizer access
-    mutable std::mutex normalizer_mutex_;
+    // Cross-run token cache on disk (nullptr unless configured)
+    std::unique_ptr<PersistentTokenCache> persistent_cache_;
 
     // Internal analysis state
     struct AnalysisState {
         HashIndex index;
         std::vector<TokenizedFile> tokenized_files;
-        std::map<uint32_t, std::string> sources;  // file_id -> source code
+
+        // SoA token columns (parallel to tokenized_files), arena-backed
+        // so the whole corpus costs a few block allocations
+        Arena token_arena;
+        std::vector<TokenColumns> token_columns;
         std::map<uint32_t, size_t> line_counts;   // file_id -> line count
 
         int64_t tokenize_time_ms = 0;
@@ -109,18 +178,66 @@ private:
         size_t total_tokens = 0;         // Total tokens processed
         size_t thread_count = 0;         // Number of threads used
         bool parallel_enabled = false;   // Whether parallel processing was used
+
+        // Hot-path instrumentation for this run (see AnalysisMetrics)
+        size_t candidate_pairs = 0;      // Raw pairs out of the matcher
+        size_t surviving_pairs = 0;      // Pairs left after merge/size filters
+
+        // Byte-identical file groups from the content-dedup pass: each
+        // group is path-sorted with the tokenized representative first.
+        // Copies get file_ids and line counts but never enter indexing
+        // or windowed matching.
+        std::vector<std::vector<std::string>> identical_groups;
+
+        // Content dedup on/off for this run. Enabled for the directory
+        // and file-list flows; compare() and incremental analysis keep
+        // every file (incremental stores need locations for each path).
+        bool dedup_identical = false;
+
+        // Out-of-core matching state (config_.max_memory_mb). With more
+        // than one partition, windows live in one spill file per hash
+        // range instead of the index, and find_clones scans them one
+        // partition at a time.
+        size_t index_partitions = 1;
+        std::filesystem::path spill_dir;
+        std::vector<std::filesystem::path> spill_files;
+        size_t spilled_locations = 0;
+
+        // Progress sinks for the progressive analyze() overload
+        // (nullptr for the plain flows)
+        const AnalysisProgress* progress = nullptr;
     };
 
     /**
-     * Get or create normalizer for a language.
+     * Get this thread's normalizer for a language, creating it lazily.
+     *
+     * Normalizers are stateless between normalize() calls, so each
+     * worker keeps its own set: the tokenize loop takes no lock at
+     * all, instead of serializing every file on a shared-map mutex.
      */
-    TokenNormalizer* get_normalizer(Language lang);
+    static TokenNormalizer* get_normalizer(Language lang);
 
     /**
      * Initialize thread pool and cache if needed.
      */
     void ensure_initialized();
 
+    /**
+     * Incremental variant of analyze(): loads the persisted index from
+     * config_.index_cache_path, re-tokenizes only files whose fingerprint
+     * changed, removes stale index entries for modified/deleted files,
+     * and saves the updated store afterwards.
+     *
+     * Note: Type-2 classification needs token data, which is only
+     * available for re-tokenized files; clones between unchanged files
+     * fall back to Type-1. Snippet previews are unaffected — they are
+     * read lazily from disk at report time.
+     */
+    SimilarityReport analyze_incremental(
+        const std::vector<std::filesystem::path>& files,
+        std::chrono::high_resolution_clock::time_point start_time
+    );
+
     /**
      * Phase 1: Tokenize all files (with parallel support).
      */
@@ -129,6 +246,28 @@ private:
         AnalysisState& state
     );
 
+    /**
+     * Phase 1, pipelined: overlap directory discovery with tokenization.
+     * Discovery streams paths into the thread pool through a bounded
+     * queue, so tokenization starts while the walk is still running.
+     * Results are sorted by path before file_ids are assigned, matching
+     * the deterministic ordering of the find_files() + tokenize_files()
+     * flow.
+     */
+    void tokenize_streamed(
+        const std::filesystem::path& root,
+        AnalysisState& state
+    );
+
+    /**
+     * Shared tail of the tokenize phases: token totals, metrics, SoA
+     * columns, and phase timing.
+     */
+    void finish_tokenization(
+        AnalysisState& state,
+        std::chrono::high_resolution_clock::time_point start
+    );
+
     /**
      * Tokenize a single file (thread-safe).
      */
@@ -136,24 +275,75 @@ private:
         const std::filesystem::path& file_path
     );
 
+    /**
+     * Tokenize already-loaded source for a file (thread-safe).
+     * The view is only read during the call; no copy is made.
+     */
+    std::optional<TokenizedFile> tokenize_source(
+        const std::filesystem::path& file_path,
+        std::string_view source
+    );
+
+    /**
+     * Tokenize with the persistent cache consulted first: a fresh cache
+     * entry skips parsing entirely; a miss tokenizes and stores the
+     * result for the next run. Callers that already probed the
+     * persistent cache for this file pass persistent_missed so the
+     * miss isn't re-done (the lookup stats and fingerprints a cache
+     * entry on disk).
+     */
+    std::optional<TokenizedFile> tokenize_with_cache(
+        const std::filesystem::path& file_path,
+        std::string_view source,
+        bool persistent_missed = false
+    );
+
     /**
      * Phase 2: Build hash index from tokenized files.
      */
     void build_index(AnalysisState& state) const;
 
+    /**
+     * Decide how many hash-range partitions matching needs to stay
+     * under config_.max_memory_mb. Returns 1 (in-memory flow) when the
+     * budget is unset, the estimated footprint fits, or the run is
+     * incremental (the persisted store needs the whole index).
+     */
+    size_t plan_index_partitions(const AnalysisState& state) const;
+
+    /**
+     * Spill variant of phase 2: files are registered on the index as
+     * usual, but windows are routed by hash range into one temporary
+     * file per partition instead of the in-memory index. find_clones
+     * then scans the partitions one at a time.
+     */
+    void build_index_spilled(AnalysisState& state, size_t num_partitions) const;
+
     /**
      * Phase 3: Find and filter clone pairs.
      */
     std::vector<ClonePair> find_clones(AnalysisState& state);
 
+    /**
+     * Raw pair production for the out-of-core flow: load one spill
+     * partition into the index, scan it, release it, repeat. Because
+     * partitioning is by hash value, every location of a given hash
+     * lands in the same partition, so the pair set (and the hot-hash
+     * suppression cap) behaves exactly like the single-index scan.
+     */
+    std::vector<ClonePair> find_pairs_spilled(
+        AnalysisState& state,
+        const HashIndex::CandidateSink& candidate_sink
+    );
+
     /**
      * Phase 4: Generate report from clone pairs.
      */
-    static SimilarityReport generate_report(
+    SimilarityReport generate_report(
         const std::vector<ClonePair>& clones,
         const AnalysisState& state,
         int64_t total_time_ms
-    );
+    ) const;
 
     /**
      * Classify clone type based on hash match type.
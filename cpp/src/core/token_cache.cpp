@@ -0,0 +1,165 @@
+#include "core/token_cache.hpp"
+#include <cstdio>
+#include <fstream>
+
+namespace aegis::similarity {
+
+namespace {
+
+// Entry format: magic + version, source path, fingerprint, line
+// counters, then the raw token array (NormalizedToken is a POD)
+constexpr uint32_t CACHE_MAGIC = 0x4145544B;  // "AETK"
+constexpr uint32_t CACHE_VERSION = 1;
+
+template<typename T>
+void write_pod(std::ostream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+bool read_pod(std::istream& in, T& value) {
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return in.good();
+}
+
+uint64_t fnv1a64(const std::string& data) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (const unsigned char c : data) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+}  // anonymous namespace
+
+PersistentTokenCache::PersistentTokenCache(std::filesystem::path directory)
+    : directory_(std::move(directory))
+{
+    std::error_code ec;
+    std::filesystem::create_directories(directory_, ec);
+}
+
+std::filesystem::path PersistentTokenCache::entry_path(
+    const std::string& source_path
+) const {
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.tok",
+             static_cast<unsigned long long>(fnv1a64(source_path)));
+    return directory_ / name;
+}
+
+std::optional<TokenizedFile> PersistentTokenCache::load(
+    const std::filesystem::path& source_path
+) const {
+    // One stat validates the entry; content is never read on a hit
+    const auto current = IndexStore::fingerprint(source_path);
+    if (!current) {
+        return std::nullopt;
+    }
+
+    std::ifstream in(entry_path(source_path.string()), std::ios::binary);
+    if (!in) {
+        return std::nullopt;
+    }
+
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    if (!read_pod(in, magic) || magic != CACHE_MAGIC) return std::nullopt;
+    if (!read_pod(in, version) || version != CACHE_VERSION) return std::nullopt;
+
+    uint32_t path_size = 0;
+    if (!read_pod(in, path_size)) return std::nullopt;
+    std::string path(path_size, '\0');
+    in.read(path.data(), path_size);
+    if (!in.good() || path != source_path.string()) {
+        return std::nullopt;  // Name-hash collision with another file
+    }
+
+    FileFingerprint fp;
+    if (!read_pod(in, fp.mtime) ||
+        !read_pod(in, fp.size) ||
+        !read_pod(in, fp.line_count)) {
+        return std::nullopt;
+    }
+    if (!fp.matches(*current)) {
+        return std::nullopt;  // Source changed since the entry was written
+    }
+
+    TokenizedFile file;
+    file.path = std::move(path);
+
+    uint64_t token_count = 0;
+    if (!read_pod(in, file.total_lines) ||
+        !read_pod(in, file.code_lines) ||
+        !read_pod(in, file.blank_lines) ||
+        !read_pod(in, file.comment_lines) ||
+        !read_pod(in, token_count)) {
+        return std::nullopt;
+    }
+
+    file.tokens.resize(token_count);
+    in.read(reinterpret_cast<char*>(file.tokens.data()),
+            static_cast<std::streamsize>(token_count * sizeof(NormalizedToken)));
+    if (!in.good()) {
+        return std::nullopt;
+    }
+
+    return file;
+}
+
+bool PersistentTokenCache::store(const TokenizedFile& file) const {
+    const auto fp = IndexStore::fingerprint(file.path);
+    if (!fp) {
+        return false;
+    }
+
+    const auto final_path = entry_path(file.path);
+    auto tmp_path = final_path;
+    tmp_path += ".tmp";
+
+    {
+        std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            return false;
+        }
+
+        write_pod(out, CACHE_MAGIC);
+        write_pod(out, CACHE_VERSION);
+
+        write_pod(out, static_cast<uint32_t>(file.path.size()));
+        out.write(file.path.data(), static_cast<std::streamsize>(file.path.size()));
+
+        write_pod(out, fp->mtime);
+        write_pod(out, fp->size);
+        write_pod(out, file.total_lines);  // line_count slot of the fingerprint
+
+        write_pod(out, file.total_lines);
+        write_pod(out, file.code_lines);
+        write_pod(out, file.blank_lines);
+        write_pod(out, file.comment_lines);
+
+        write_pod(out, static_cast<uint64_t>(file.tokens.size()));
+        out.write(reinterpret_cast<const char*>(file.tokens.data()),
+                  static_cast<std::streamsize>(file.tokens.size() * sizeof(NormalizedToken)));
+
+        if (!out.good()) {
+            out.close();
+            std::error_code ec;
+            std::filesystem::remove(tmp_path, ec);
+            return false;
+        }
+    }
+
+    // Atomic publish: readers see either the old entry or the new one
+    std::error_code ec;
+    std::filesystem::rename(tmp_path, final_path, ec);
+    if (ec) {
+        std::filesystem::remove(tmp_path, ec);
+        return false;
+    }
+
+    return true;
+}
+
+}  // namespace aegis::similarity
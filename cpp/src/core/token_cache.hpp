@@ -0,0 +1,54 @@
+#pragma once
+
+#include "core/index_store.hpp"
+#include "models/clone_types.hpp"
+#include <filesystem>
+#include <optional>
+
+namespace aegis::similarity {
+
+/**
+ * Persistent cross-run cache of tokenized files.
+ *
+ * One compact binary entry per source file, stored under a cache
+ * directory and named by a hash of the source path. Entries carry the
+ * source's mtime/size fingerprint and are validated with a single stat
+ * on load, so warm runs skip the tokenize phase without re-reading or
+ * re-parsing content. Writes go through a temp file + rename, so a
+ * concurrent reader (another worker thread or process) never observes
+ * a torn entry.
+ */
+class PersistentTokenCache {
+public:
+    /**
+     * Open (and create if needed) a cache rooted at the directory.
+     */
+    explicit PersistentTokenCache(std::filesystem::path directory);
+
+    /**
+     * Load the cached tokenization for a source file.
+     *
+     * @return The tokens, or nullopt if the entry is missing,
+     *         unreadable, or stale relative to the file on disk
+     */
+    std::optional<TokenizedFile> load(
+        const std::filesystem::path& source_path
+    ) const;
+
+    /**
+     * Store a tokenized file, fingerprinted against the source on disk.
+     *
+     * @return true on success
+     */
+    bool store(const TokenizedFile& file) const;
+
+private:
+    /**
+     * Cache entry location for a source path.
+     */
+    std::filesystem::path entry_path(const std::string& source_path) const;
+
+    std::filesystem::path directory_;
+};
+
+}  // namespace aegis::similarity
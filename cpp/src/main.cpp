@@ -36,6 +36,9 @@ void print_usage(const char* program) {
               << "  --threshold <f>      Similarity threshold 0.0-1.0 (default: 0.7)\n"
               << "  --type3              Enable Type-3 detection (clones with gaps)\n"
               << "  --max-gap <n>        Maximum gap for Type-3 detection (default: 5)\n"
+              << "  --incremental        Reuse persisted index, only process changed files\n"
+              << "  --index-cache <path> Index store location for --incremental\n"
+              << "  --token-cache <dir>  Persistent token cache directory (reused across runs)\n"
               << "  --compare <f1> <f2>  Compare two specific files\n"
               << "  --socket <path>      Run as server on Unix socket\n"
               << "  --pretty             Pretty-print JSON output\n"
@@ -58,6 +61,9 @@ struct CliArgs {
     float similarity_threshold = 0.7f;
     bool detect_type3 = false;
     size_t max_gap_tokens = 5;
+    bool incremental = false;
+    std::string index_cache_path;
+    std::string token_cache_dir;
     bool pretty_print = false;
     std::string compare_file1;
     std::string compare_file2;
@@ -215,6 +221,9 @@ CliArgs parse_args(int argc, char* argv[]) {
         if (try_parse_float_arg(arg, "--threshold", i, argc, argv, args.similarity_threshold)) continue;
         if (try_parse_flag(arg, "--type3", args.detect_type3)) continue;
         if (try_parse_size_arg(arg, "--max-gap", i, argc, argv, args.max_gap_tokens)) continue;
+        if (try_parse_flag(arg, "--incremental", args.incremental)) continue;
+        if (try_parse_string_arg(arg, "--index-cache", i, argc, argv, args.index_cache_path)) continue;
+        if (try_parse_string_arg(arg, "--token-cache", i, argc, argv, args.token_cache_dir)) continue;
         if (try_parse_compare(arg, i, argc, argv, args)) continue;
         if (try_parse_string_arg(arg, "--socket", i, argc, argv, args.socket_path)) continue;
         if (try_parse_flag(arg, "--pretty", args.pretty_print)) continue;
@@ -284,6 +293,9 @@ int main(int argc, char* argv[]) {
     config.max_gap_tokens = args.max_gap_tokens;
     config.extensions = args.extensions;
     config.exclude_patterns = args.exclude_patterns;
+    config.incremental = args.incremental;
+    config.index_cache_path = args.index_cache_path;
+    config.token_cache_dir = args.token_cache_dir;
 
     SimilarityDetector detector(config);
 
@@ -308,11 +320,13 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    // Output report
+    // Output report. The compact path streams entry by entry instead of
+    // materializing the whole DOM and its dumped string first.
     if (args.pretty_print) {
         std::cout << report.to_json_string(2) << "\n";
     } else {
-        std::cout << report.to_json_string(-1) << "\n";
+        report.to_json_stream(std::cout);
+        std::cout << "\n";
     }
 
     return 0;
@@ -86,6 +86,11 @@ struct HashLocation {
     uint32_t token_start;  // Start index in token array
     uint32_t token_count;  // Number of tokens in this region
 
+    // MinHash sketch of the tokens surrounding this window (see
+    // RegionSketch); lets the matcher cheaply reject candidate pairs
+    // whose neighborhoods have nothing in common
+    uint64_t context_sketch = 0;
+
     // Check if this location overlaps with another
     [[nodiscard]] bool overlaps(const HashLocation& other) const {
         if (file_id != other.file_id) return false;
@@ -167,9 +172,34 @@ struct DetectorConfig {
     // Maximum gap allowed for Type-3 extension
     size_t max_gap_tokens = 5;
 
+    // Hashes with more locations than this are classified as boilerplate
+    // and excluded from pair generation (0 = no cap). Suppressed hashes
+    // and their frequencies surface in the report's metrics section.
+    size_t max_locations_per_hash = 5000;
+
     // Number of threads (0 = auto-detect)
     size_t num_threads = 0;
 
+    // Soft memory ceiling in megabytes (0 = unlimited). When the
+    // estimated footprint of tokens plus hash index exceeds this,
+    // matching runs out-of-core: window hashes are spilled to temporary
+    // files partitioned by hash range and scanned one partition at a
+    // time, so only a fraction of the index is resident at once.
+    // Slower, but finishes on constrained runners instead of OOMing.
+    // Ignored in incremental mode (the persisted store needs the whole
+    // index in memory to save).
+    size_t max_memory_mb = 0;
+
+    // Enable incremental analysis: persist the hash index across runs and
+    // only re-tokenize/re-index files whose fingerprint changed
+    bool incremental = false;
+
+    // Path to the persisted index store (required when incremental is set)
+    std::string index_cache_path;
+
+    // Directory for the persistent cross-run token cache (empty = disabled)
+    std::string token_cache_dir;
+
     // File extensions to analyze
     std::vector<std::string> extensions = {".py"};
 
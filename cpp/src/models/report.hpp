@@ -2,6 +2,9 @@
 
 #include "models/clone_types.hpp"
 #include <nlohmann/json.hpp>
+#include <cstdio>
+#include <functional>
+#include <ostream>
 #include <string>
 #include <vector>
 #include <chrono>
@@ -79,16 +82,22 @@ inline std::string sanitize_utf8(const std::string& input) {
 
 /**
  * Detailed information about a clone location for the report.
+ *
+ * The file is referenced by id into SimilarityReport::file_table; the
+ * path string is materialized only at serialization, so a report with
+ * many clones never duplicates paths per entry.
  */
 struct CloneLocationInfo {
-    std::string file;
+    uint32_t file_id = 0;
     uint32_t start_line;
     uint32_t end_line;
     std::string snippet_preview;  // First few lines of the clone
 
-    nlohmann::json to_json() const {
+    nlohmann::json to_json(const std::vector<std::string>& file_table) const {
         return {
-            {"file", sanitize_utf8(file)},
+            {"file", file_id < file_table.size()
+                ? sanitize_utf8(file_table[file_id])
+                : "unknown"},
             {"start_line", start_line},
             {"end_line", end_line},
             {"snippet_preview", sanitize_utf8(snippet_preview)}
@@ -96,6 +105,31 @@ struct CloneLocationInfo {
     }
 };
 
+/**
+ * A group of byte-identical files found by the content-dedup pass.
+ *
+ * Identical content is a complete clone by definition, so these never
+ * go through windowed matching: only the representative (the first id)
+ * was tokenized and indexed, and the group is reported directly.
+ */
+struct IdenticalFileGroup {
+    std::vector<uint32_t> file_ids;  // Representative first, then copies
+    size_t line_count = 0;           // Lines per file in the group
+
+    nlohmann::json to_json(const std::vector<std::string>& file_table) const {
+        auto files = nlohmann::json::array();
+        for (const auto id : file_ids) {
+            files.push_back(id < file_table.size()
+                ? sanitize_utf8(file_table[id])
+                : "unknown");
+        }
+        return {
+            {"files", files},
+            {"line_count", line_count}
+        };
+    }
+};
+
 /**
  * A complete clone entry for the report.
  */
@@ -106,10 +140,10 @@ struct CloneEntry {
     std::vector<CloneLocationInfo> locations;
     std::string recommendation;
 
-    nlohmann::json to_json() const {
+    nlohmann::json to_json(const std::vector<std::string>& file_table) const {
         nlohmann::json locs = nlohmann::json::array();
         for (const auto& loc : locations) {
-            locs.push_back(loc.to_json());
+            locs.push_back(loc.to_json(file_table));
         }
 
         return {
@@ -120,6 +154,14 @@ struct CloneEntry {
             {"recommendation", recommendation}
         };
     }
+
+    /**
+     * Write this entry as compact JSON directly to a stream.
+     * Only the per-entry DOM is materialized, never the whole array's.
+     */
+    void to_json_stream(std::ostream& out, const std::vector<std::string>& file_table) const {
+        out << to_json(file_table).dump();
+    }
 };
 
 /**
@@ -173,6 +215,13 @@ struct PerformanceMetrics {
     size_t thread_count = 0;           // Number of threads used
     bool parallel_enabled = false;     // Whether parallel processing was used
 
+    // Hot-path instrumentation for this run
+    size_t hashes_inserted = 0;        // Locations added to the hash index
+    size_t candidate_pairs = 0;        // Raw pairs out of the matcher
+    size_t surviving_pairs = 0;        // Pairs left after merge/size filters
+    double cache_hit_rate = 0.0;       // In-memory token cache hit ratio
+    size_t peak_rss_bytes = 0;         // Peak resident set size of the process
+
     nlohmann::json to_json() const {
         return {
             {"loc_per_second", loc_per_second},
@@ -180,7 +229,12 @@ struct PerformanceMetrics {
             {"tokens_per_second", tokens_per_second},
             {"files_per_second", files_per_second},
             {"thread_count", thread_count},
-            {"parallel_enabled", parallel_enabled}
+            {"parallel_enabled", parallel_enabled},
+            {"hashes_inserted", hashes_inserted},
+            {"candidate_pairs", candidate_pairs},
+            {"surviving_pairs", surviving_pairs},
+            {"cache_hit_rate", cache_hit_rate},
+            {"peak_rss_bytes", peak_rss_bytes}
         };
     }
 };
@@ -192,10 +246,30 @@ struct ReportMetrics {
     std::map<std::string, size_t> by_type;      // Type-1, Type-2, Type-3
     std::map<std::string, size_t> by_language;  // python, javascript, etc.
 
+    // Hot-hash suppression: hashes exceeding the configured cap
+    // (DetectorConfig::max_locations_per_hash) with their frequencies
+    size_t suppressed_hashes = 0;
+    size_t suppressed_locations = 0;
+    std::vector<std::pair<uint64_t, size_t>> suppressed;
+
     nlohmann::json to_json() const {
+        auto suppressed_json = nlohmann::json::array();
+        for (const auto& [hash, count] : suppressed) {
+            char buf[17];
+            std::snprintf(buf, sizeof(buf), "%016llx",
+                          static_cast<unsigned long long>(hash));
+            suppressed_json.push_back({
+                {"hash", buf},
+                {"locations", count}
+            });
+        }
+
         return {
             {"by_type", by_type},
-            {"by_language", by_language}
+            {"by_language", by_language},
+            {"suppressed_hashes", suppressed_hashes},
+            {"suppressed_locations", suppressed_locations},
+            {"suppressed", suppressed_json}
         };
     }
 };
@@ -209,7 +283,10 @@ struct ReportMetrics {
 class SimilarityReport {
 public:
     ReportSummary summary;
+    // File paths stored once, indexed by CloneLocationInfo::file_id
+    std::vector<std::string> file_table;
     std::vector<CloneEntry> clones;
+    std::vector<IdenticalFileGroup> identical_file_groups;
     std::vector<DuplicationHotspot> hotspots;
     ReportMetrics metrics;
     TimingInfo timing;
@@ -225,20 +302,17 @@ public:
 
         j["clones"] = nlohmann::json::array();
         for (const auto& clone : clones) {
-            j["clones"].push_back(clone.to_json());
+            j["clones"].push_back(clone.to_json(file_table));
+        }
+
+        j["identical_files"] = nlohmann::json::array();
+        for (const auto& group : identical_file_groups) {
+            j["identical_files"].push_back(group.to_json(file_table));
         }
 
         j["hotspots"] = nlohmann::json::array();
         for (const auto& hotspot : hotspots) {
-            j["hotspots"].push_back({
-                {"file", sanitize_utf8(hotspot.file_path)},
-                {"duplication_score", hotspot.duplication_score},
-                {"clone_count", hotspot.clone_count},
-                {"recommendation",
-                    hotspot.duplication_score > 0.3
-                        ? "High duplication - review for refactoring opportunities"
-                        : "Moderate duplication - consider consolidating similar code"}
-            });
+            j["hotspots"].push_back(hotspot_to_json(hotspot));
         }
 
         j["metrics"] = metrics.to_json();
@@ -255,17 +329,85 @@ public:
         return to_json().dump(indent);
     }
 
+    /**
+     * Write the report as compact JSON directly to a stream.
+     *
+     * The clones array — by far the dominant part of a large report —
+     * is emitted one entry at a time, so peak serialization memory is
+     * bounded by a single entry instead of the whole DOM plus its
+     * dumped string, and the consumer sees the first bytes immediately.
+     */
+    void to_json_stream(std::ostream& out) const {
+        out << "{\"summary\":" << summary.to_json().dump();
+
+        out << ",\"clones\":[";
+        for (size_t i = 0; i < clones.size(); ++i) {
+            if (i > 0) out << ',';
+            clones[i].to_json_stream(out, file_table);
+        }
+        out << ']';
+
+        out << ",\"identical_files\":[";
+        for (size_t i = 0; i < identical_file_groups.size(); ++i) {
+            if (i > 0) out << ',';
+            out << identical_file_groups[i].to_json(file_table).dump();
+        }
+        out << ']';
+
+        out << ",\"hotspots\":[";
+        for (size_t i = 0; i < hotspots.size(); ++i) {
+            if (i > 0) out << ',';
+            out << hotspot_to_json(hotspots[i]).dump();
+        }
+        out << ']';
+
+        out << ",\"metrics\":" << metrics.to_json().dump();
+        out << ",\"timing\":" << timing.to_json().dump();
+        out << ",\"performance\":" << performance.to_json().dump();
+        out << '}';
+    }
+
+    /**
+     * Build the report JSON for a single hotspot.
+     */
+    static nlohmann::json hotspot_to_json(const DuplicationHotspot& hotspot) {
+        return {
+            {"file", sanitize_utf8(hotspot.file_path)},
+            {"duplication_score", hotspot.duplication_score},
+            {"clone_count", hotspot.clone_count},
+            {"recommendation",
+                hotspot.duplication_score > 0.3
+                    ? "High duplication - review for refactoring opportunities"
+                    : "Moderate duplication - consider consolidating similar code"}
+        };
+    }
+
+    // Lines of source shown per clone location
+    static constexpr uint32_t SNIPPET_PREVIEW_LINES = 3;
+
+    /**
+     * Callback yielding raw source lines for a preview: given a file_id
+     * and a 1-based start line, return up to SNIPPET_PREVIEW_LINES lines
+     * of source (empty string = source unavailable). The report owns
+     * formatting (truncation, UTF-8 sanitizing); the provider owns
+     * access, so callers can read lazily from disk instead of keeping
+     * the corpus resident.
+     */
+    using SnippetProvider =
+        std::function<std::string(uint32_t file_id, uint32_t start_line)>;
+
     /**
      * Add a clone pair to the report.
      *
+     * Locations carry the pair's file_ids; file_table must cover those
+     * ids by serialization time (ids out of range render as "unknown").
+     *
      * @param pair The clone pair
-     * @param file_paths Map of file_id to file path
-     * @param sources Map of file_id to source code (for snippet extraction)
+     * @param snippets Optional source access for previews (empty = "...")
      */
     void add_clone(
         const ClonePair& pair,
-        const std::vector<std::string>& file_paths,
-        const std::map<uint32_t, std::string>& sources = {}
+        const SnippetProvider& snippets = {}
     ) {
         CloneEntry entry;
         entry.id = "clone_" + std::to_string(clones.size() + 1);
@@ -274,29 +416,25 @@ public:
 
         // Location A
         CloneLocationInfo loc_a;
-        loc_a.file = pair.location_a.file_id < file_paths.size()
-            ? file_paths[pair.location_a.file_id]
-            : "unknown";
+        loc_a.file_id = pair.location_a.file_id;
         loc_a.start_line = pair.location_a.start_line;
         loc_a.end_line = pair.location_a.end_line;
         loc_a.snippet_preview = extract_snippet(
             pair.location_a.file_id,
             pair.location_a.start_line,
-            sources
+            snippets
         );
         entry.locations.push_back(loc_a);
 
         // Location B
         CloneLocationInfo loc_b;
-        loc_b.file = pair.location_b.file_id < file_paths.size()
-            ? file_paths[pair.location_b.file_id]
-            : "unknown";
+        loc_b.file_id = pair.location_b.file_id;
         loc_b.start_line = pair.location_b.start_line;
         loc_b.end_line = pair.location_b.end_line;
         loc_b.snippet_preview = extract_snippet(
             pair.location_b.file_id,
             pair.location_b.start_line,
-            sources
+            snippets
         );
         entry.locations.push_back(loc_b);
 
@@ -316,7 +454,6 @@ public:
      * represents what percentage of the file's lines are involved in clones.
      */
     void calculate_hotspots(
-        const std::vector<std::string>& file_paths,
         const std::map<uint32_t, size_t>& file_line_counts
     ) {
         // Track clone counts and unique duplicated line ranges per file
@@ -326,16 +463,13 @@ public:
 
         for (const auto& clone : clones) {
             for (const auto& loc : clone.locations) {
-                // Find file ID
-                for (size_t i = 0; i < file_paths.size(); ++i) {
-                    if (file_paths[i] == loc.file) {
-                        clone_counts[i]++;
-                        // Add each line in the range to the set (deduplicates overlaps)
-                        for (uint32_t line = loc.start_line; line <= loc.end_line; ++line) {
-                            duplicated_line_sets[i].insert(line);
-                        }
-                        break;
-                    }
+                if (loc.file_id >= file_table.size()) {
+                    continue;
+                }
+                clone_counts[loc.file_id]++;
+                // Add each line in the range to the set (deduplicates overlaps)
+                for (uint32_t line = loc.start_line; line <= loc.end_line; ++line) {
+                    duplicated_line_sets[loc.file_id].insert(line);
                 }
             }
         }
@@ -344,9 +478,7 @@ public:
         hotspots.clear();
         for (const auto& [file_id, count] : clone_counts) {
             DuplicationHotspot hotspot;
-            hotspot.file_path = file_id < file_paths.size()
-                ? file_paths[file_id]
-                : "unknown";
+            hotspot.file_path = file_table[file_id];
             hotspot.clone_count = static_cast<uint32_t>(count);
 
             // Count unique duplicated lines (no double-counting)
@@ -443,46 +575,33 @@ private:
     std::string extract_snippet(
         uint32_t file_id,
         uint32_t start_line,
-        const std::map<uint32_t, std::string>& sources
+        const SnippetProvider& snippets
     ) {
-        auto it = sources.find(file_id);
-        if (it == sources.end()) {
+        if (!snippets) {
             return "...";
         }
 
-        const auto& source = it->second;
-        std::vector<std::string> lines;
+        const std::string raw = snippets(file_id, start_line);
+        if (raw.empty()) {
+            return "...";
+        }
 
-        // Split into lines
+        // Truncate long lines to keep previews compact
+        std::string result;
         size_t pos = 0;
-        uint32_t line_num = 1;
-        while (pos < source.size()) {
-            size_t end = source.find('\n', pos);
-            if (end == std::string::npos) end = source.size();
-
-            if (line_num >= start_line && line_num < start_line + 3) {
-                std::string line = source.substr(pos, end - pos);
-                // Truncate long lines
-                if (line.size() > 60) {
-                    line = line.substr(0, 57) + "...";
-                }
-                lines.push_back(line);
-            }
+        while (pos <= raw.size()) {
+            size_t end = raw.find('\n', pos);
+            if (end == std::string::npos) end = raw.size();
 
-            if (line_num >= start_line + 2) break;
+            if (pos > 0) result += '\n';
+            if (end - pos > 60) {
+                result += raw.substr(pos, 57) + "...";
+            } else {
+                result += raw.substr(pos, end - pos);
+            }
 
+            if (end == raw.size()) break;
             pos = end + 1;
-            line_num++;
-        }
-
-        if (lines.empty()) {
-            return "...";
-        }
-
-        std::string result;
-        for (size_t i = 0; i < lines.size(); ++i) {
-            if (i > 0) result += "\n";
-            result += lines[i];
         }
 
         // Sanitize to ensure valid UTF-8 for JSON
@@ -0,0 +1,204 @@
+#include "server/fs_watcher.hpp"
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cstring>
+#include <iostream>
+
+namespace aegis::server {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Events that mean "this path's content or existence changed".
+// IN_CLOSE_WRITE instead of IN_MODIFY: one event per save instead of
+// one per write() call.
+constexpr uint32_t WATCH_MASK =
+    IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_TO | IN_MOVED_FROM;
+
+}  // anonymous namespace
+
+FsWatcher::FsWatcher(Config config, Callback on_change)
+    : config_(std::move(config))
+    , on_change_(std::move(on_change))
+{
+}
+
+FsWatcher::~FsWatcher() {
+    stop();
+}
+
+bool FsWatcher::start() {
+    if (running_.load()) {
+        return true;
+    }
+
+    std::error_code ec;
+    if (!fs::is_directory(config_.root, ec)) {
+        return false;
+    }
+
+    inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd_ < 0) {
+        std::cerr << "inotify_init1 failed: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    add_watch_recursive(config_.root);
+
+    running_.store(true);
+    thread_ = std::thread([this] { run(); });
+    return true;
+}
+
+void FsWatcher::stop() {
+    running_.store(false);
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    if (inotify_fd_ >= 0) {
+        // Closing the descriptor drops every watch in one call
+        close(inotify_fd_);
+        inotify_fd_ = -1;
+    }
+    watches_.clear();
+    pending_.clear();
+}
+
+FsWatcher::Stats FsWatcher::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats;
+    stats.running = running_.load();
+    stats.watched_dirs = watches_.size();
+    stats.events_seen = events_seen_.load();
+    stats.flushes = flushes_.load();
+    return stats;
+}
+
+bool FsWatcher::is_ignored_dir(const fs::path& name) const {
+    const std::string n = name.string();
+    for (const auto& ignored : config_.ignored_dirs) {
+        if (n == ignored) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FsWatcher::extension_matches(const fs::path& path) const {
+    if (config_.extensions.empty()) {
+        return true;
+    }
+    const std::string ext = path.extension().string();
+    for (const auto& candidate : config_.extensions) {
+        if (ext == candidate) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void FsWatcher::add_watch_recursive(const fs::path& dir) {
+    const int wd = inotify_add_watch(inotify_fd_, dir.c_str(), WATCH_MASK);
+    if (wd < 0) {
+        return;  // Permissions/limit: skip this subtree
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        watches_[wd] = dir;
+    }
+
+    std::error_code ec;
+    for (fs::directory_iterator it(dir, ec), end; !ec && it != end;
+         it.increment(ec)) {
+        if (it->is_directory(ec) && !is_ignored_dir(it->path().filename())) {
+            add_watch_recursive(it->path());
+        }
+    }
+}
+
+void FsWatcher::run() {
+    // Large enough for a burst of events with long names
+    alignas(inotify_event) char buffer[16 * 1024];
+
+    while (running_.load()) {
+        struct pollfd pfd{};
+        pfd.fd = inotify_fd_;
+        pfd.events = POLLIN;
+
+        // Tick at the debounce interval so a quiet tree flushes promptly
+        const int timeout_ms =
+            static_cast<int>(config_.debounce.count() > 0
+                ? config_.debounce.count() : 100);
+        const int poll_result = poll(&pfd, 1, timeout_ms);
+        if (poll_result < 0 && errno != EINTR) {
+            break;
+        }
+
+        if (poll_result > 0) {
+            const ssize_t bytes = read(inotify_fd_, buffer, sizeof(buffer));
+            for (ssize_t offset = 0; offset < bytes; ) {
+                const auto* event =
+                    reinterpret_cast<const inotify_event*>(buffer + offset);
+                offset += static_cast<ssize_t>(sizeof(inotify_event)) + event->len;
+
+                fs::path dir;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    const auto it = watches_.find(event->wd);
+                    if (it == watches_.end()) {
+                        continue;
+                    }
+                    dir = it->second;
+                }
+
+                if (event->len == 0) {
+                    continue;
+                }
+                const fs::path full = dir / event->name;
+
+                if (event->mask & IN_ISDIR) {
+                    // New subtree: watch it so edits inside are seen
+                    if ((event->mask & (IN_CREATE | IN_MOVED_TO)) &&
+                        !is_ignored_dir(full.filename())) {
+                        add_watch_recursive(full);
+                    }
+                    continue;
+                }
+
+                if (!extension_matches(full)) {
+                    continue;
+                }
+
+                events_seen_.fetch_add(1, std::memory_order_relaxed);
+                std::lock_guard<std::mutex> lock(mutex_);
+                pending_.insert(full.string());
+                last_event_ = std::chrono::steady_clock::now();
+            }
+        }
+
+        // Flush once the tree has been quiet for the debounce interval
+        std::vector<std::string> batch;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!pending_.empty() &&
+                std::chrono::steady_clock::now() - last_event_ >= config_.debounce) {
+                batch.assign(pending_.begin(), pending_.end());
+                pending_.clear();
+            }
+        }
+
+        if (!batch.empty()) {
+            flushes_.fetch_add(1, std::memory_order_relaxed);
+            try {
+                on_change_(batch);
+            } catch (const std::exception& e) {
+                std::cerr << "Watch refresh failed: " << e.what() << std::endl;
+            }
+        }
+    }
+}
+
+}  // namespace aegis::server
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace aegis::server {
+
+/**
+ * Recursive inotify watcher with debounced change delivery.
+ *
+ * Watches every directory under a root and collects write/create/
+ * delete/move events for files matching the configured extensions.
+ * Events are not delivered one by one: an editor save or a branch
+ * switch produces a burst, so the callback fires only after the tree
+ * has been quiet for the debounce interval, with the batch of touched
+ * paths seen since the last flush.
+ *
+ * The callback runs on the watcher's own thread; it may be arbitrarily
+ * slow (events keep accumulating meanwhile and flush on the next quiet
+ * period). Directories created while watching are picked up and
+ * watched recursively.
+ */
+class FsWatcher {
+public:
+    using Callback = std::function<void(const std::vector<std::string>& changed)>;
+
+    struct Config {
+        std::filesystem::path root;
+
+        // File extensions that count as changes (empty = all files)
+        std::vector<std::string> extensions;
+
+        // Quiet period before a batch of events is flushed
+        std::chrono::milliseconds debounce{500};
+
+        // Directory names never descended into; mirrors the detector's
+        // default exclude patterns so tool churn (git, caches) doesn't
+        // trigger refreshes
+        std::vector<std::string> ignored_dirs = {
+            ".git", "node_modules", "__pycache__", "venv", ".venv"
+        };
+    };
+
+    struct Stats {
+        bool running = false;
+        size_t watched_dirs = 0;
+        size_t events_seen = 0;
+        size_t flushes = 0;
+    };
+
+    FsWatcher(Config config, Callback on_change);
+    ~FsWatcher();
+
+    // Non-copyable (owns a thread and kernel watch descriptors)
+    FsWatcher(const FsWatcher&) = delete;
+    FsWatcher& operator=(const FsWatcher&) = delete;
+
+    /**
+     * Initialize inotify, register watches for the whole tree and start
+     * the event thread. Returns false if the root doesn't exist or the
+     * inotify descriptor can't be created.
+     */
+    bool start();
+
+    /**
+     * Stop the event thread and drop all watches. Idempotent; also run
+     * by the destructor.
+     */
+    void stop();
+
+    Stats stats() const;
+
+private:
+    Config config_;
+    Callback on_change_;
+
+    int inotify_fd_ = -1;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+
+    // Watch descriptor -> directory path, so event names (relative to
+    // their watch) can be resolved to full paths
+    std::map<int, std::filesystem::path> watches_;
+
+    // Batch under construction; flushed after the quiet period
+    std::set<std::string> pending_;
+    std::chrono::steady_clock::time_point last_event_;
+
+    mutable std::mutex mutex_;
+    std::atomic<size_t> events_seen_{0};
+    std::atomic<size_t> flushes_{0};
+
+    /**
+     * Register a watch for a directory and every subdirectory, skipping
+     * ignored names.
+     */
+    void add_watch_recursive(const std::filesystem::path& dir);
+
+    /**
+     * Event loop: drain inotify, grow watches for new directories, and
+     * flush the pending batch once the tree has been quiet.
+     */
+    void run();
+
+    bool extension_matches(const std::filesystem::path& path) const;
+    bool is_ignored_dir(const std::filesystem::path& name) const;
+};
+
+}  // namespace aegis::server
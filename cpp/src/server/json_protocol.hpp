@@ -1,8 +1,10 @@
 #pragma once
 
 #include <nlohmann/json.hpp>
+#include <functional>
 #include <string>
 #include <optional>
+#include <utility>
 
 namespace aegis::server {
 
@@ -80,6 +82,78 @@ struct Response {
     }
 };
 
+/**
+ * Incremental writer for streamed responses.
+ *
+ * A streamed response is a sequence of newline-delimited frames that
+ * share the request id:
+ *
+ *   {"id": "uuid", "stream": {...}}       zero or more data frames
+ *   {"id": "uuid", "stream_end": true}    terminator on success
+ *   {"id": "uuid", "error": {...}}        terminator on failure
+ *
+ * Clients that see "stream" instead of "result" collect data frames
+ * until a terminator arrives. Each frame is serialized and written as
+ * soon as it is produced, so the peak memory of a streamed method is
+ * one frame, not the whole payload.
+ */
+class StreamWriter {
+public:
+    /** Sink writes one serialized frame; returns false if the peer is gone. */
+    using Sink = std::function<bool(const std::string&)>;
+
+    StreamWriter(std::string id, Sink sink)
+        : id_(std::move(id)), sink_(std::move(sink)) {}
+
+    /**
+     * Emit one data frame. Returns false once the sink has failed;
+     * callers should stop producing at that point.
+     */
+    bool write_frame(json payload) {
+        if (failed_) return false;
+        json frame;
+        frame["id"] = id_;
+        frame["stream"] = std::move(payload);
+        return send(frame);
+    }
+
+    /**
+     * Emit the success terminator.
+     */
+    bool finish() {
+        if (failed_) return false;
+        json frame;
+        frame["id"] = id_;
+        frame["stream_end"] = true;
+        return send(frame);
+    }
+
+    /**
+     * Emit the error terminator.
+     */
+    bool fail(const std::string& message, int code) {
+        json frame;
+        frame["id"] = id_;
+        frame["error"] = ErrorInfo{message, code}.to_json();
+        return send(frame);
+    }
+
+    /** True once a write has failed (client disconnected). */
+    [[nodiscard]] bool broken() const { return failed_; }
+
+private:
+    bool send(const json& frame) {
+        if (!sink_(frame.dump() + "\n")) {
+            failed_ = true;
+        }
+        return !failed_;
+    }
+
+    std::string id_;
+    Sink sink_;
+    bool failed_ = false;
+};
+
 /**
  * Error codes following JSON-RPC conventions.
  */
@@ -1,17 +1,73 @@
 #include "server/uds_server.hpp"
+#include "server/fs_watcher.hpp"
+#include "core/federated_index.hpp"
+#include "core/index_store.hpp"
 #include "utils/file_utils.hpp"
+#include "utils/metrics.hpp"
+#include "utils/snippet_reader.hpp"
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <sys/un.h>
 #include <unistd.h>
 #include <poll.h>
+#include <algorithm>
+#include <chrono>
+#include <climits>
 #include <cstring>
+#include <future>
 #include <iostream>
 #include <filesystem>
+#include <mutex>
+#include <thread>
 
 namespace aegis::server {
 
 namespace fs = std::filesystem;
 
+namespace {
+
+/**
+ * Write a batch of buffers to a socket with writev, retrying partial
+ * writes. One syscall per IOV_MAX buffers instead of one per response,
+ * and no coalescing copy of large response bodies.
+ */
+bool write_vectored(const int fd, const std::vector<std::string>& buffers) {
+    std::vector<iovec> iov;
+    iov.reserve(buffers.size());
+    for (const auto& buf : buffers) {
+        if (!buf.empty()) {
+            iov.push_back({const_cast<char*>(buf.data()), buf.size()});
+        }
+    }
+
+    size_t current = 0;
+    while (current < iov.size()) {
+        const auto count = static_cast<int>(
+            std::min(iov.size() - current, static_cast<size_t>(IOV_MAX)));
+        ssize_t written = writev(fd, iov.data() + current, count);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+
+        // Advance past fully sent buffers; trim a partially sent one
+        while (written > 0) {
+            auto& entry = iov[current];
+            if (static_cast<size_t>(written) >= entry.iov_len) {
+                written -= static_cast<ssize_t>(entry.iov_len);
+                ++current;
+            } else {
+                entry.iov_base = static_cast<char*>(entry.iov_base) + written;
+                entry.iov_len -= static_cast<size_t>(written);
+                written = 0;
+            }
+        }
+    }
+    return true;
+}
+
+}  // anonymous namespace
+
 UDSServer::UDSServer(Config config)
     : config_(std::move(config))
 {
@@ -25,6 +81,10 @@ void UDSServer::register_method(const std::string& name, MethodHandler handler)
     methods_[name] = std::move(handler);
 }
 
+void UDSServer::register_stream_method(const std::string& name, StreamMethodHandler handler) {
+    stream_methods_[name] = std::move(handler);
+}
+
 bool UDSServer::create_socket() {
     // Remove existing socket file
     unlink(config_.socket_path.c_str());
@@ -65,6 +125,7 @@ void UDSServer::run() {
     }
 
     running_.store(true);
+    connection_pool_ = std::make_unique<ThreadPool>(config_.worker_threads);
     std::cerr << "Server listening on " << config_.socket_path << std::endl;
 
     while (!shutdown_requested_.load()) {
@@ -92,10 +153,22 @@ void UDSServer::run() {
             continue;
         }
 
-        // Handle client (single-threaded for simplicity)
-        handle_client(client_fd);
-        close(client_fd);
+        // Dispatch to the connection pool so one slow client (e.g. a
+        // multi-second analyze) doesn't block the accept loop
+        ++active_connections_;
+        connection_pool_->submit([this, client_fd]() {
+            handle_client(client_fd);
+            close(client_fd);
+            --active_connections_;
+        });
+    }
+
+    // In-flight connections notice the shutdown flag on their next poll
+    // tick; give them time to finish their current request
+    while (active_connections_.load() > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
+    connection_pool_.reset();
 
     running_.store(false);
     cleanup();
@@ -128,30 +201,107 @@ void UDSServer::handle_client(int client_fd) {
         chunk[bytes] = '\0';
         buffer += chunk;
 
-        // Process complete lines
+        // Drain every complete line before dispatching: pipelined
+        // clients send a burst of requests before reading any response
+        std::vector<std::string> lines;
         size_t pos;
         while ((pos = buffer.find('\n')) != std::string::npos) {
             std::string line = buffer.substr(0, pos);
             buffer.erase(0, pos + 1);
+            if (!line.empty()) {
+                lines.push_back(std::move(line));
+            }
+        }
+        if (lines.empty()) continue;
+
+        // Streaming methods write frames straight to the socket as
+        // they are produced, so they act as pipeline barriers: the
+        // batch of plain requests before one is flushed first, in
+        // order, then the stream runs inline
+        std::vector<std::string> batch;
+        for (auto& line : lines) {
+            if (auto req = Request::parse(line)) {
+                auto it = stream_methods_.find(req->method);
+                if (it != stream_methods_.end()) {
+                    if (!process_pipelined(std::move(batch), client_fd)) {
+                        return;
+                    }
+                    batch.clear();
+                    if (!process_stream_request(*req, it->second, client_fd)) {
+                        return;  // Client went away mid-stream
+                    }
+                    continue;
+                }
+            }
+            batch.push_back(std::move(line));
+        }
+        if (!process_pipelined(std::move(batch), client_fd)) {
+            return;
+        }
+
+        // Check for shutdown method
+        if (shutdown_requested_.load()) {
+            return;
+        }
+    }
+}
 
-            if (line.empty()) continue;
+bool UDSServer::process_pipelined(std::vector<std::string> lines, const int client_fd) {
+    if (lines.empty()) {
+        return true;
+    }
 
-            Response response = process_request(line);
-            std::string response_str = response.serialize();
+    // Each call is claimed exactly once. Pool workers accelerate the
+    // batch when they have spare capacity; the connection thread (a
+    // pool worker itself) claims whatever is left, so waiting on the
+    // futures can't deadlock even with every worker stuck in a
+    // connection loop.
+    struct PendingCall {
+        std::string line;
+        std::atomic<bool> claimed{false};
+        std::promise<Response> done;
+    };
+
+    std::vector<std::shared_ptr<PendingCall>> calls;
+    calls.reserve(lines.size());
+    for (auto& line : lines) {
+        auto call = std::make_shared<PendingCall>();
+        call->line = std::move(line);
+        calls.push_back(std::move(call));
+    }
 
-            // Send response
-            ssize_t written = write(client_fd, response_str.c_str(), response_str.size());
-            if (written < 0) {
-                std::cerr << "Write error: " << strerror(errno) << std::endl;
-                return;
-            }
+    std::vector<std::future<Response>> futures;
+    futures.reserve(calls.size());
+    for (auto& call : calls) {
+        futures.push_back(call->done.get_future());
+    }
 
-            // Check for shutdown method
-            if (shutdown_requested_.load()) {
-                return;
-            }
+    const auto run = [this](const std::shared_ptr<PendingCall>& call) {
+        if (!call->claimed.exchange(true)) {
+            call->done.set_value(process_request(call->line));
         }
+    };
+
+    for (size_t i = 1; i < calls.size(); ++i) {
+        connection_pool_->submit([run, call = calls[i]] { run(call); });
+    }
+    for (auto& call : calls) {
+        run(call);
     }
+
+    // Gather in request order: responses go out in the order the
+    // requests arrived regardless of which finished first
+    std::vector<std::string> responses;
+    responses.reserve(calls.size());
+    for (auto& future : futures) {
+        responses.push_back(future.get().serialize());
+    }
+
+    if (!write_vectored(client_fd, responses)) {
+        std::cerr << "Write error: " << strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
 }
 
 Response UDSServer::process_request(const std::string& line) {
@@ -178,6 +328,34 @@ Response UDSServer::process_request(const std::string& line) {
     }
 }
 
+bool UDSServer::process_stream_request(
+    const Request& req,
+    const StreamMethodHandler& handler,
+    const int client_fd
+) {
+    StreamWriter writer(req.id, [client_fd](const std::string& frame) {
+        size_t sent = 0;
+        while (sent < frame.size()) {
+            const ssize_t written = write(client_fd, frame.data() + sent, frame.size() - sent);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            sent += static_cast<size_t>(written);
+        }
+        return true;
+    });
+
+    try {
+        handler(req.params, writer);
+        writer.finish();
+    } catch (const std::exception& e) {
+        writer.fail(e.what(), ErrorCode::INTERNAL_ERROR);
+    }
+
+    return !writer.broken();
+}
+
 void UDSServer::shutdown() {
     shutdown_requested_.store(true);
 }
@@ -194,45 +372,258 @@ void UDSServer::cleanup() {
 // Factory function with AEGIS methods
 // =============================================================================
 
+namespace {
+
+/**
+ * One detector shared by all connections, so the token cache (and any
+ * loaded index) persists across requests. Heavy methods reconfigure
+ * the detector and therefore serialize on analysis_mutex; cheap
+ * methods read the internally synchronized cache without taking it.
+ */
+struct SharedDetector {
+    SimilarityDetector detector;
+    std::mutex analysis_mutex;
+
+    // Active snapshot store, set by save_snapshot/load_snapshot
+    // (guarded by analysis_mutex). When non-empty, analyze-style
+    // methods run incrementally against it: unchanged files cost one
+    // stat instead of a tokenize + index pass.
+    std::string snapshot_path;
+
+    // Filesystem watcher for 'watch_start': keeps the snapshot warm by
+    // refreshing it in the background whenever the watched root
+    // changes. Root/params are captured at watch_start time and
+    // guarded by analysis_mutex like everything else heavy.
+    std::unique_ptr<FsWatcher> watcher;
+    std::string watch_root;
+    json watch_params;
+    std::atomic<size_t> watch_refreshes{0};
+};
+
+/**
+ * Build a detector configuration from analyze-style request params.
+ *
+ * A per-request "snapshot" param overrides the server-wide snapshot
+ * path; either one switches the run to incremental mode against that
+ * store.
+ */
+DetectorConfig analysis_config(const json& params,
+                               const std::string& snapshot_path = "") {
+    std::vector<std::string> extensions;
+    if (params.contains("extensions")) {
+        for (const auto& ext : params["extensions"]) {
+            extensions.push_back(ext.get<std::string>());
+        }
+    }
+    if (extensions.empty()) {
+        extensions = {".py"};  // Default
+    }
+
+    DetectorConfig cfg;
+    cfg.extensions = std::move(extensions);
+    cfg.window_size = params.value("window_size", 10);
+    cfg.min_clone_tokens = params.value("min_tokens", 30);
+    cfg.max_gap_tokens = params.value("max_gap", 5);
+    cfg.similarity_threshold = params.value("min_similarity", 0.7f);
+    cfg.num_threads = params.value("threads", 4);
+    cfg.detect_type3 = params.value("type3", false);
+
+    if (const std::string snapshot = params.value("snapshot", snapshot_path);
+        !snapshot.empty()) {
+        cfg.incremental = true;
+        cfg.index_cache_path = snapshot;
+    }
+    return cfg;
+}
+
+}  // anonymous namespace
+
 std::unique_ptr<UDSServer> create_aegis_server(const UDSServer::Config& config) {
     auto server = std::make_unique<UDSServer>(config);
+    auto shared = std::make_shared<SharedDetector>();
 
     // Register 'analyze' method
-    server->register_method("analyze", [](const json& params) -> json {
+    server->register_method("analyze", [shared](const json& params) -> json {
         std::string root = params.value("root", "");
         if (root.empty()) {
             throw std::runtime_error("Missing 'root' parameter");
         }
 
-        // Get extensions
-        std::vector<std::string> extensions;
-        if (params.contains("extensions")) {
-            for (const auto& ext : params["extensions"]) {
-                extensions.push_back(ext.get<std::string>());
-            }
-        }
-        if (extensions.empty()) {
-            extensions = {".py"};  // Default
-        }
-
-        // Configure detector
-        DetectorConfig cfg;
-        cfg.extensions = extensions;
-        cfg.window_size = params.value("window_size", 10);
-        cfg.min_clone_tokens = params.value("min_tokens", 30);
-        cfg.max_gap_tokens = params.value("max_gap", 5);
-        cfg.similarity_threshold = params.value("min_similarity", 0.7f);
-        cfg.num_threads = params.value("threads", 4);
-        cfg.detect_type3 = params.value("type3", false);
-
-        // Run analysis
-        SimilarityDetector detector(cfg);
-        auto report = detector.analyze(root);
+        // Run analysis on the shared detector
+        std::lock_guard<std::mutex> lock(shared->analysis_mutex);
+        shared->detector.set_config(
+            analysis_config(params, shared->snapshot_path));
+        auto report = shared->detector.analyze(root);
 
         // Convert to JSON
         return report.to_json();
     });
 
+    // Register 'analyze_stream': same analysis as 'analyze', but the
+    // clones array is delivered in chunked frames (see StreamWriter) so
+    // large reports reach the client incrementally instead of as one
+    // giant response line
+    server->register_stream_method("analyze_stream",
+        [shared](const json& params, StreamWriter& writer) {
+            std::string root = params.value("root", "");
+            if (root.empty()) {
+                throw std::runtime_error("Missing 'root' parameter");
+            }
+
+            SimilarityReport report;
+            {
+                std::lock_guard<std::mutex> lock(shared->analysis_mutex);
+                shared->detector.set_config(
+                    analysis_config(params, shared->snapshot_path));
+                report = shared->detector.analyze(root);
+            }
+
+            if (!writer.write_frame({{"summary", report.summary.to_json()}})) {
+                return;
+            }
+
+            constexpr size_t CLONES_PER_FRAME = 256;
+            json batch = json::array();
+            for (const auto& clone : report.clones) {
+                batch.push_back(clone.to_json(report.file_table));
+                if (batch.size() >= CLONES_PER_FRAME) {
+                    if (!writer.write_frame({{"clones", std::move(batch)}})) {
+                        return;
+                    }
+                    batch = json::array();
+                }
+            }
+            if (!batch.empty()) {
+                if (!writer.write_frame({{"clones", std::move(batch)}})) {
+                    return;
+                }
+            }
+
+            json hotspots = json::array();
+            for (const auto& hotspot : report.hotspots) {
+                hotspots.push_back(SimilarityReport::hotspot_to_json(hotspot));
+            }
+            writer.write_frame({
+                {"hotspots", std::move(hotspots)},
+                {"metrics", report.metrics.to_json()},
+                {"timing", report.timing.to_json()},
+                {"performance", report.performance.to_json()}
+            });
+        });
+
+    // Register 'analyze_progressive': like 'analyze_stream', but phase
+    // events and raw candidate pairs are framed while the analysis is
+    // still running, so time-to-first-clone is decoupled from total
+    // time. Candidate frames are pre-merge matcher output (file ids
+    // resolve against the "tokenized" frame's file table); the final
+    // frames carry the same refined report as 'analyze_stream'.
+    server->register_stream_method("analyze_progressive",
+        [shared](const json& params, StreamWriter& writer) {
+            std::string root = params.value("root", "");
+            if (root.empty()) {
+                throw std::runtime_error("Missing 'root' parameter");
+            }
+
+            constexpr size_t CANDIDATES_PER_FRAME = 256;
+            json pending = json::array();
+            bool client_gone = false;
+
+            AnalysisProgress progress;
+            progress.on_tokenized = [&](const std::vector<std::string>& file_table,
+                                        const size_t total_tokens) {
+                if (client_gone) return;
+                json files = json::array();
+                for (const auto& path : file_table) {
+                    files.push_back(path);
+                }
+                client_gone = !writer.write_frame({
+                    {"event", "tokenized"},
+                    {"files", std::move(files)},
+                    {"tokens", total_tokens}
+                });
+            };
+            progress.on_indexed = [&](const size_t unique_hashes,
+                                      const size_t locations) {
+                if (client_gone) return;
+                client_gone = !writer.write_frame({
+                    {"event", "indexed"},
+                    {"hashes", unique_hashes},
+                    {"locations", locations}
+                });
+            };
+            progress.on_candidates = [&](const std::vector<ClonePair>& pairs) {
+                if (client_gone) return;
+                for (const auto& pair : pairs) {
+                    pending.push_back({
+                        {"file_a", pair.location_a.file_id},
+                        {"lines_a", {pair.location_a.start_line,
+                                     pair.location_a.end_line}},
+                        {"file_b", pair.location_b.file_id},
+                        {"lines_b", {pair.location_b.start_line,
+                                     pair.location_b.end_line}},
+                        {"tokens", pair.token_count()}
+                    });
+                }
+                if (pending.size() >= CANDIDATES_PER_FRAME) {
+                    client_gone = !writer.write_frame({
+                        {"event", "candidates"},
+                        {"pairs", std::move(pending)}
+                    });
+                    pending = json::array();
+                }
+            };
+
+            SimilarityReport report;
+            {
+                std::lock_guard<std::mutex> lock(shared->analysis_mutex);
+                shared->detector.set_config(
+                    analysis_config(params, shared->snapshot_path));
+                report = shared->detector.analyze(root, progress);
+            }
+
+            if (client_gone) {
+                return;
+            }
+            if (!pending.empty()) {
+                if (!writer.write_frame({{"event", "candidates"},
+                                         {"pairs", std::move(pending)}})) {
+                    return;
+                }
+            }
+
+            if (!writer.write_frame({{"summary", report.summary.to_json()}})) {
+                return;
+            }
+
+            constexpr size_t CLONES_PER_FRAME = 256;
+            json batch = json::array();
+            for (const auto& clone : report.clones) {
+                batch.push_back(clone.to_json(report.file_table));
+                if (batch.size() >= CLONES_PER_FRAME) {
+                    if (!writer.write_frame({{"clones", std::move(batch)}})) {
+                        return;
+                    }
+                    batch = json::array();
+                }
+            }
+            if (!batch.empty()) {
+                if (!writer.write_frame({{"clones", std::move(batch)}})) {
+                    return;
+                }
+            }
+
+            json hotspots = json::array();
+            for (const auto& hotspot : report.hotspots) {
+                hotspots.push_back(SimilarityReport::hotspot_to_json(hotspot));
+            }
+            writer.write_frame({
+                {"hotspots", std::move(hotspots)},
+                {"metrics", report.metrics.to_json()},
+                {"timing", report.timing.to_json()},
+                {"performance", report.performance.to_json()}
+            });
+        });
+
     // Register the 'file_tree' method
     server->register_method("file_tree", [](const json& params) -> json {
         std::string root = params.value("root", "");
@@ -271,8 +662,50 @@ std::unique_ptr<UDSServer> create_aegis_server(const UDSServer::Config& config)
         return {{"files", files}, {"count", files.size()}};
     });
 
+    // Register the 'get_snippet' method: on-demand source access. Clone
+    // entries carry only (file_id, line range); clients resolve the
+    // file through the report's file_table and fetch the lines here, so
+    // neither side ever holds whole files for snippet display.
+    server->register_method("get_snippet", [](const json& params) -> json {
+        std::string file = params.value("file", "");
+        if (file.empty()) {
+            throw std::runtime_error("Missing 'file' parameter");
+        }
+
+        uint32_t start_line = params.value("start_line", 1u);
+        if (start_line == 0) start_line = 1;
+
+        // Range via end_line (inclusive, matching clone locations) or
+        // an explicit line_count; default is a preview-sized read
+        // Bound the response so one request can't stream a whole file
+        constexpr uint32_t MAX_SNIPPET_LINES = 500;
+
+        uint32_t line_count = params.value("line_count", 0u);
+        if (const uint32_t end_line = params.value("end_line", 0u);
+            end_line >= start_line) {
+            line_count = end_line - start_line + 1;
+        }
+        if (line_count == 0) {
+            line_count = SimilarityReport::SNIPPET_PREVIEW_LINES;
+        }
+        line_count = std::min(line_count, MAX_SNIPPET_LINES);
+
+        SnippetReader reader;
+        const auto text = reader.read_lines(file, start_line, line_count);
+        if (text.empty() && !fs::exists(file)) {
+            throw std::runtime_error("Cannot read file: " + file);
+        }
+
+        return {
+            {"file", file},
+            {"start_line", start_line},
+            {"line_count", line_count},
+            {"text", sanitize_utf8(text)}
+        };
+    });
+
     // Register 'compare_files' method
-    server->register_method("compare_files", [](const json& params) -> json {
+    server->register_method("compare_files", [shared](const json& params) -> json {
         std::string file1 = params.value("file1", "");
         std::string file2 = params.value("file2", "");
 
@@ -288,15 +721,16 @@ std::unique_ptr<UDSServer> create_aegis_server(const UDSServer::Config& config)
         cfg.detect_type3 = params.value("type3", false);
         cfg.max_gap_tokens = params.value("max_gap", 5);
 
-        // Run comparison
-        SimilarityDetector detector(cfg);
-        auto report = detector.compare(file1, file2);
+        // Run comparison on the shared detector
+        std::lock_guard<std::mutex> lock(shared->analysis_mutex);
+        shared->detector.set_config(cfg);
+        auto report = shared->detector.compare(file1, file2);
 
         return report.to_json();
     });
 
     // Register 'get_hotspots' method
-    server->register_method("get_hotspots", [](const json& params) -> json {
+    server->register_method("get_hotspots", [shared](const json& params) -> json {
         std::string root = params.value("root", "");
         if (root.empty()) {
             throw std::runtime_error("Missing 'root' parameter");
@@ -321,8 +755,9 @@ std::unique_ptr<UDSServer> create_aegis_server(const UDSServer::Config& config)
         cfg.min_clone_tokens = params.value("min_tokens", 30);
         cfg.similarity_threshold = params.value("min_similarity", 0.7f);
 
-        SimilarityDetector detector(cfg);
-        auto report = detector.analyze(root);
+        std::lock_guard<std::mutex> lock(shared->analysis_mutex);
+        shared->detector.set_config(cfg);
+        auto report = shared->detector.analyze(root);
 
         // Extract top hotspots
         json result = json::array();
@@ -343,7 +778,7 @@ std::unique_ptr<UDSServer> create_aegis_server(const UDSServer::Config& config)
     });
 
     // Register 'get_file_clones' method
-    server->register_method("get_file_clones", [](const json& params) -> json {
+    server->register_method("get_file_clones", [shared](const json& params) -> json {
         std::string root = params.value("root", "");
         std::string target_file = params.value("file", "");
 
@@ -368,37 +803,300 @@ std::unique_ptr<UDSServer> create_aegis_server(const UDSServer::Config& config)
         cfg.min_clone_tokens = params.value("min_tokens", 30);
         cfg.similarity_threshold = params.value("min_similarity", 0.7f);
 
-        SimilarityDetector detector(cfg);
-        auto report = detector.analyze(root);
+        std::lock_guard<std::mutex> lock(shared->analysis_mutex);
+        shared->detector.set_config(cfg);
+        auto report = shared->detector.analyze(root);
 
         // Filter clones involving the target file
         json file_clones = json::array();
         for (const auto& clone : report.clones) {
             bool involves_file = false;
             for (const auto& loc : clone.locations) {
+                if (loc.file_id >= report.file_table.size()) {
+                    continue;
+                }
+                const auto& path = report.file_table[loc.file_id];
                 // Check if path contains target file (could be absolute or relative)
-                if (loc.file.find(target_file) != std::string::npos ||
-                    target_file.find(loc.file) != std::string::npos) {
+                if (path.find(target_file) != std::string::npos ||
+                    target_file.find(path) != std::string::npos) {
                     involves_file = true;
                     break;
                 }
             }
             if (involves_file) {
-                file_clones.push_back(clone.to_json());
+                file_clones.push_back(clone.to_json(report.file_table));
             }
         }
 
         return {{"file", target_file}, {"clones", file_clones}, {"count", file_clones.size()}};
     });
 
-    // Register 'get_cache_stats' method
-    server->register_method("get_cache_stats", [](const json& /*params*/) -> json {
-        // Create a detector to access cache stats
-        // Note: Each call creates a new detector with its own cache
-        // In a production system, we'd want a persistent detector instance
+    // Register 'save_snapshot': analyze a tree and persist the index
+    // image plus per-file fingerprints at the given path. The snapshot
+    // becomes the server's active store, so later analyze requests (and
+    // a restarted server after 'load_snapshot') warm-start from it.
+    server->register_method("save_snapshot", [shared](const json& params) -> json {
+        std::string root = params.value("root", "");
+        std::string path = params.value("path", "");
+        if (root.empty() || path.empty()) {
+            throw std::runtime_error("Missing 'root' or 'path' parameter");
+        }
+
+        std::lock_guard<std::mutex> lock(shared->analysis_mutex);
+        shared->detector.set_config(analysis_config(params, path));
+        auto report = shared->detector.analyze(root);
+        shared->snapshot_path = path;
+
+        std::error_code ec;
+        const auto bytes = fs::file_size(path, ec);
+        return {
+            {"path", path},
+            {"bytes", ec ? 0 : bytes},
+            {"files", report.summary.files_analyzed},
+            {"clone_pairs", report.summary.clone_pairs_found}
+        };
+    });
+
+    // Register 'load_snapshot': validate a snapshot written by
+    // 'save_snapshot' and make it the active store. The index image
+    // loads straight into query-ready form (see HashIndex::load), so a
+    // fresh server is useful after a few bulk reads instead of a cold
+    // analysis.
+    server->register_method("load_snapshot", [shared](const json& params) -> json {
+        std::string path = params.value("path", "");
+        if (path.empty()) {
+            throw std::runtime_error("Missing 'path' parameter");
+        }
+
+        IndexStore store;
+        if (!store.load(path)) {
+            throw std::runtime_error("Cannot load snapshot: " + path);
+        }
+        const auto stats = store.index.get_stats();
+
+        std::lock_guard<std::mutex> lock(shared->analysis_mutex);
+        shared->snapshot_path = path;
+
+        return {
+            {"path", path},
+            {"files", stats.total_files},
+            {"hashes", stats.total_hashes},
+            {"locations", stats.total_locations}
+        };
+    });
+
+    // Register 'federate': merge per-repo snapshot artifacts (written
+    // by each repo's own save_snapshot) and report only the clones that
+    // cross artifact boundaries — intra-repo pairs are already in each
+    // repo's own report. Stateless: nothing touches the server's active
+    // store, so federation queries can run beside normal analysis.
+    server->register_method("federate", [](const json& params) -> json {
+        const auto artifacts =
+            params.value("artifacts", std::vector<std::string>{});
+        if (artifacts.size() < 2) {
+            throw std::runtime_error(
+                "'artifacts' needs at least two snapshot paths");
+        }
+
+        FederatedIndex::Config cfg;
+        cfg.min_clone_tokens =
+            params.value("min_clone_tokens", cfg.min_clone_tokens);
+        cfg.similarity_threshold =
+            params.value("similarity_threshold", cfg.similarity_threshold);
+
+        FederatedIndex federation(cfg);
+        for (const auto& path : artifacts) {
+            if (!federation.add_artifact(path)) {
+                throw std::runtime_error("Cannot load artifact: " + path);
+            }
+        }
+
+        const auto clones = federation.find_cross_clones();
+
+        json artifact_list = json::array();
+        for (const auto& info : federation.artifacts()) {
+            artifact_list.push_back({
+                {"source", info.source},
+                {"files", info.file_count},
+                {"locations", info.location_count}
+            });
+        }
+
+        const auto location_json = [&](const HashLocation& loc) -> json {
+            return {
+                {"file", federation.index().get_file_path(loc.file_id)},
+                {"artifact", federation.artifact_of(loc.file_id)},
+                {"start_line", loc.start_line},
+                {"end_line", loc.end_line},
+                {"tokens", loc.token_count}
+            };
+        };
+
+        json clone_list = json::array();
+        for (const auto& pair : clones) {
+            clone_list.push_back({
+                {"a", location_json(pair.location_a)},
+                {"b", location_json(pair.location_b)},
+                {"similarity", pair.similarity}
+            });
+        }
+
+        return {
+            {"artifacts", artifact_list},
+            {"cross_clones", clone_list},
+            {"count", clone_list.size()}
+        };
+    });
+
+    // Register 'watch_start': watch a root with inotify and keep its
+    // snapshot warm. Change bursts are debounced; each flush runs the
+    // incremental path against the snapshot (the fingerprint delta
+    // re-tokenizes only the touched files and HashIndexBuilder appends
+    // them onto the loaded index), so 'analyze' requests between saves
+    // find an up-to-date store and return in milliseconds.
+    server->register_method("watch_start", [shared](const json& params) -> json {
+        const std::string root = params.value("root", "");
+        if (root.empty()) {
+            throw std::runtime_error("Missing 'root' parameter");
+        }
+
+        // Detach any previous watcher under the lock, but join its
+        // thread outside it: a refresh in flight is itself waiting on
+        // analysis_mutex
+        std::unique_ptr<FsWatcher> previous;
+        std::string snapshot;
+        {
+            std::lock_guard<std::mutex> lock(shared->analysis_mutex);
+            snapshot = params.value("snapshot", shared->snapshot_path);
+            if (snapshot.empty()) {
+                throw std::runtime_error(
+                    "No snapshot: pass 'snapshot' or call save_snapshot first");
+            }
+            previous = std::move(shared->watcher);
+        }
+        if (previous) {
+            previous->stop();
+            previous.reset();
+        }
+
+        std::lock_guard<std::mutex> lock(shared->analysis_mutex);
+        shared->watch_root = root;
+        shared->watch_params = params;
+        shared->snapshot_path = snapshot;
+        shared->watch_refreshes.store(0);
+
+        const auto cfg = analysis_config(params, snapshot);
+
+        FsWatcher::Config watch_cfg;
+        watch_cfg.root = root;
+        watch_cfg.extensions = cfg.extensions;
+        watch_cfg.debounce =
+            std::chrono::milliseconds(params.value("debounce_ms", 500));
+
+        // The refresh holds analysis_mutex like any heavy method, so it
+        // never races an in-flight analyze. A weak_ptr keeps the
+        // watcher thread from pinning the shared state alive.
+        std::weak_ptr<SharedDetector> weak = shared;
+        shared->watcher = std::make_unique<FsWatcher>(
+            std::move(watch_cfg),
+            [weak](const std::vector<std::string>&) {
+                const auto state = weak.lock();
+                if (!state) return;
+                std::lock_guard<std::mutex> refresh_lock(state->analysis_mutex);
+                state->detector.set_config(
+                    analysis_config(state->watch_params, state->snapshot_path));
+                state->detector.analyze(state->watch_root);
+                state->watch_refreshes.fetch_add(1, std::memory_order_relaxed);
+            });
+
+        if (!shared->watcher->start()) {
+            shared->watcher.reset();
+            throw std::runtime_error("Cannot watch root: " + root);
+        }
+
+        // Prime the snapshot so the first change event starts from a
+        // current baseline (a missing store becomes a full build here,
+        // not on the watcher thread)
+        shared->detector.set_config(analysis_config(params, snapshot));
+        const auto report = shared->detector.analyze(root);
+
+        const auto stats = shared->watcher->stats();
+        return {
+            {"root", root},
+            {"snapshot", snapshot},
+            {"watched_dirs", stats.watched_dirs},
+            {"files", report.summary.files_analyzed}
+        };
+    });
+
+    // Register 'watch_stop': stop the watcher; the snapshot stays
+    // active for analyze requests.
+    server->register_method("watch_stop", [shared](const json& /*params*/) -> json {
+        // Same split as watch_start: detach under the lock, join outside
+        std::unique_ptr<FsWatcher> watcher;
+        {
+            std::lock_guard<std::mutex> lock(shared->analysis_mutex);
+            watcher = std::move(shared->watcher);
+        }
+        const bool was_running = watcher != nullptr;
+        if (watcher) {
+            watcher->stop();
+        }
+        return {{"stopped", was_running}};
+    });
+
+    // Register 'watch_status': watcher and refresh counters.
+    server->register_method("watch_status", [shared](const json& /*params*/) -> json {
+        std::lock_guard<std::mutex> lock(shared->analysis_mutex);
+        if (!shared->watcher) {
+            return {{"running", false}};
+        }
+        const auto stats = shared->watcher->stats();
+        return {
+            {"running", stats.running},
+            {"root", shared->watch_root},
+            {"snapshot", shared->snapshot_path},
+            {"watched_dirs", stats.watched_dirs},
+            {"events_seen", stats.events_seen},
+            {"flushes", stats.flushes},
+            {"refreshes", shared->watch_refreshes.load()}
+        };
+    });
+
+    // Register 'get_cache_stats' method. The cache pointer is fixed at
+    // detector construction and the cache is internally synchronized,
+    // so this stays cheap — and safe without the analysis lock — even
+    // while an analysis runs on another connection.
+    server->register_method("get_cache_stats", [shared](const json& /*params*/) -> json {
+        const auto stats = shared->detector.cache_stats();
+        return {
+            {"hits", stats.hits},
+            {"misses", stats.misses},
+            {"current_size", stats.current_size},
+            {"capacity", stats.capacity},
+            {"hit_rate", stats.hit_rate()}
+        };
+    });
+
+    // Register 'get_metrics' method. Counters are process-wide relaxed
+    // atomics (see AnalysisMetrics), so a dashboard can scrape this
+    // while a long analysis runs on another connection.
+    server->register_method("get_metrics", [shared](const json& /*params*/) -> json {
+        const auto snap = similarity::AnalysisMetrics::global().snapshot();
+        const auto cache = shared->detector.cache_stats();
         return {
-            {"message", "Cache stats not available in stateless mode"},
-            {"note", "Each request creates a new detector instance"}
+            {"files_tokenized", snap.files_tokenized},
+            {"tokens_produced", snap.tokens_produced},
+            {"hashes_inserted", snap.hashes_inserted},
+            {"candidate_pairs", snap.candidate_pairs},
+            {"surviving_pairs", snap.surviving_pairs},
+            {"analyses_completed", snap.analyses_completed},
+            {"peak_rss_bytes", snap.peak_rss_bytes},
+            {"token_cache", {
+                {"hits", cache.hits},
+                {"misses", cache.misses},
+                {"hit_rate", cache.hit_rate()}
+            }}
         };
     });
 
@@ -2,6 +2,7 @@
 
 #include "json_protocol.hpp"
 #include "core/similarity_detector.hpp"
+#include "utils/thread_pool.hpp"
 #include <string>
 #include <functional>
 #include <atomic>
@@ -18,6 +19,13 @@ using namespace aegis::similarity;
  */
 using MethodHandler = std::function<json(const json& params)>;
 
+/**
+ * Streaming method handler: produces its result incrementally through
+ * the writer instead of returning one JSON document. The server emits
+ * the success terminator after the handler returns.
+ */
+using StreamMethodHandler = std::function<void(const json& params, StreamWriter& writer)>;
+
 /**
  * Server configuration.
  */
@@ -25,6 +33,7 @@ struct ServerConfig {
     std::string socket_path = "/tmp/aegis-cpp.sock";
     int backlog = 5;
     size_t buffer_size = 65536;
+    size_t worker_threads = 4;  // Concurrent connection handlers
 };
 
 /**
@@ -63,9 +72,19 @@ public:
      */
     void register_method(const std::string& name, MethodHandler handler);
 
+    /**
+     * Register a streaming method handler. The response is emitted as
+     * chunked frames (see StreamWriter) as the handler produces them.
+     */
+    void register_stream_method(const std::string& name, StreamMethodHandler handler);
+
     /**
      * Start the server (blocking).
      * Returns when shutdown is requested.
+     *
+     * Connections are serviced concurrently by a small worker pool, so
+     * cheap requests (stats, cache queries) are not queued behind a
+     * long-running analysis on another connection.
      */
     void run();
 
@@ -86,6 +105,11 @@ private:
     std::atomic<bool> running_{false};
     std::atomic<bool> shutdown_requested_{false};
     std::unordered_map<std::string, MethodHandler> methods_;
+    std::unordered_map<std::string, StreamMethodHandler> stream_methods_;
+
+    // Connection workers; each accepted client is dispatched here
+    std::unique_ptr<ThreadPool> connection_pool_;
+    std::atomic<size_t> active_connections_{0};
 
     /**
      * Create and bind the Unix socket.
@@ -102,6 +126,27 @@ private:
      */
     Response process_request(const std::string& line);
 
+    /**
+     * Execute a batch of pipelined request lines and write the
+     * responses in request order with one vectored send.
+     *
+     * Independent requests run concurrently: each is claimed exactly
+     * once, by a pool worker when one is free or by the connection
+     * thread otherwise, so a pool fully occupied by connections can
+     * never deadlock the batch. Returns false if the client went away.
+     */
+    bool process_pipelined(std::vector<std::string> lines, int client_fd);
+
+    /**
+     * Run a streaming handler, writing frames straight to the socket.
+     * Returns false if the client went away mid-stream.
+     */
+    bool process_stream_request(
+        const Request& req,
+        const StreamMethodHandler& handler,
+        int client_fd
+    );
+
     /**
      * Clean up server resources.
      */
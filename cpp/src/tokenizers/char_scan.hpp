@@ -0,0 +1,200 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace aegis::similarity::char_scan {
+
+/**
+ * SIMD scanning fast paths shared by the language normalizers.
+ *
+ * The normalizers spend most of their time advancing over long uniform
+ * runs: whitespace, comment bodies, identifier spans, and plain string
+ * contents. These helpers classify 16 bytes per step with SSE2 (with a
+ * scalar fallback for other targets and for run tails), so the
+ * per-character state machines only run on the characters that actually
+ * need a decision.
+ *
+ * All functions return the index of the first character at or after
+ * `pos` that ends the run (or `s.size()` if the run reaches the end).
+ * The caller is responsible for line/column bookkeeping; every run here
+ * is defined so it can never contain a newline ('\n' is always a stop
+ * character), which lets callers bulk-advance the column counter.
+ */
+
+namespace detail {
+
+#if defined(__SSE2__)
+// Index of the lowest set bit; mask must be non-zero
+inline size_t first_bit(const uint32_t mask) {
+    return static_cast<size_t>(__builtin_ctz(mask));
+}
+#endif
+
+// Scalar identifier-character test: [A-Za-z0-9_] plus '$' for JS.
+// Matches std::isalnum in the C locale for ASCII; bytes >= 0x80 (UTF-8
+// continuation bytes etc.) classify as non-identifier, same as before.
+inline bool is_ident_byte(const unsigned char c, const bool allow_dollar) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+           (c >= '0' && c <= '9') || c == '_' ||
+           (allow_dollar && c == '$');
+}
+
+}  // namespace detail
+
+/**
+ * Advance over an identifier span: [A-Za-z0-9_], plus '$' when
+ * allow_dollar is set (JavaScript identifiers).
+ */
+inline size_t skip_identifier(
+    const std::string_view s, size_t pos, const bool allow_dollar = false
+) {
+#if defined(__SSE2__)
+    const __m128i below_a = _mm_set1_epi8('a' - 1);
+    const __m128i above_z = _mm_set1_epi8('z' + 1);
+    const __m128i below_0 = _mm_set1_epi8('0' - 1);
+    const __m128i above_9 = _mm_set1_epi8('9' + 1);
+    const __m128i underscore = _mm_set1_epi8('_');
+    const __m128i dollar = _mm_set1_epi8('$');
+    const __m128i case_bit = _mm_set1_epi8(0x20);
+
+    while (pos + 16 <= s.size()) {
+        const __m128i chunk = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(s.data() + pos)
+        );
+
+        // Fold case, then range-test. Signed compares are safe: bytes
+        // >= 0x80 are negative and fall below every range, classifying
+        // as non-identifier exactly like the scalar test.
+        const __m128i folded = _mm_or_si128(chunk, case_bit);
+        const __m128i alpha = _mm_and_si128(
+            _mm_cmpgt_epi8(folded, below_a),
+            _mm_cmplt_epi8(folded, above_z)
+        );
+        const __m128i digit = _mm_and_si128(
+            _mm_cmpgt_epi8(chunk, below_0),
+            _mm_cmplt_epi8(chunk, above_9)
+        );
+        __m128i ident = _mm_or_si128(
+            _mm_or_si128(alpha, digit),
+            _mm_cmpeq_epi8(chunk, underscore)
+        );
+        if (allow_dollar) {
+            ident = _mm_or_si128(ident, _mm_cmpeq_epi8(chunk, dollar));
+        }
+
+        const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(ident));
+        if (mask != 0xFFFF) {
+            return pos + detail::first_bit(~mask & 0xFFFF);
+        }
+        pos += 16;
+    }
+#endif
+    while (pos < s.size() &&
+           detail::is_ident_byte(static_cast<unsigned char>(s[pos]), allow_dollar)) {
+        ++pos;
+    }
+    return pos;
+}
+
+/**
+ * Advance over a run of ' ' and '\t' (plus '\r' when include_cr is set).
+ */
+inline size_t skip_spaces(
+    const std::string_view s, size_t pos, const bool include_cr = false
+) {
+#if defined(__SSE2__)
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i cr = _mm_set1_epi8('\r');
+
+    while (pos + 16 <= s.size()) {
+        const __m128i chunk = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(s.data() + pos)
+        );
+
+        __m128i ws = _mm_or_si128(
+            _mm_cmpeq_epi8(chunk, space),
+            _mm_cmpeq_epi8(chunk, tab)
+        );
+        if (include_cr) {
+            ws = _mm_or_si128(ws, _mm_cmpeq_epi8(chunk, cr));
+        }
+
+        const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(ws));
+        if (mask != 0xFFFF) {
+            return pos + detail::first_bit(~mask & 0xFFFF);
+        }
+        pos += 16;
+    }
+#endif
+    while (pos < s.size()) {
+        const char c = s[pos];
+        if (c != ' ' && c != '\t' && !(include_cr && c == '\r')) {
+            break;
+        }
+        ++pos;
+    }
+    return pos;
+}
+
+/**
+ * Find the first occurrence of any of up to three stop characters.
+ * Pass the same character twice to search for fewer than three.
+ */
+inline size_t find_any(
+    const std::string_view s, size_t pos,
+    const char a, const char b, const char c
+) {
+#if defined(__SSE2__)
+    const __m128i va = _mm_set1_epi8(a);
+    const __m128i vb = _mm_set1_epi8(b);
+    const __m128i vc = _mm_set1_epi8(c);
+
+    while (pos + 16 <= s.size()) {
+        const __m128i chunk = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(s.data() + pos)
+        );
+
+        const __m128i hit = _mm_or_si128(
+            _mm_or_si128(
+                _mm_cmpeq_epi8(chunk, va),
+                _mm_cmpeq_epi8(chunk, vb)
+            ),
+            _mm_cmpeq_epi8(chunk, vc)
+        );
+
+        const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(hit));
+        if (mask != 0) {
+            return pos + detail::first_bit(mask);
+        }
+        pos += 16;
+    }
+#endif
+    while (pos < s.size() && s[pos] != a && s[pos] != b && s[pos] != c) {
+        ++pos;
+    }
+    return pos;
+}
+
+/**
+ * Find the first occurrence of a single character (libc memchr, which
+ * is already vectorized).
+ */
+inline size_t find_char(const std::string_view s, const size_t pos, const char c) {
+    if (pos >= s.size()) {
+        return s.size();
+    }
+    const void* hit = std::memchr(s.data() + pos, c, s.size() - pos);
+    return hit
+        ? static_cast<size_t>(static_cast<const char*>(hit) - s.data())
+        : s.size();
+}
+
+}  // namespace aegis::similarity::char_scan
@@ -1,4 +1,5 @@
 #include "tokenizers/cpp_normalizer.hpp"
+#include "tokenizers/char_scan.hpp"
 #include <cctype>
 #include <algorithm>
 
@@ -130,6 +131,17 @@ NormalizedToken CppNormalizer::parse_string(TokenizerState& state) {
 
     std::string value;
     while (!state.eof()) {
+        // Bulk-copy the plain body up to the next character that needs
+        // a decision (closing quote, escape, or newline)
+        const size_t next = char_scan::find_any(
+            state.source, state.pos, '"', '\\', '\n'
+        );
+        if (next > state.pos) {
+            value.append(state.source.substr(state.pos, next - state.pos));
+            state.advance_run(next);
+            if (state.eof()) break;
+        }
+
         char c = state.peek();
 
         if (c == '"') {
@@ -301,12 +313,12 @@ NormalizedToken CppNormalizer::parse_identifier_or_keyword(TokenizerState& state
     tok.line = state.line;
     tok.column = state.column;
 
-    std::string value;
     const size_t start_pos = state.pos;
 
-    while (!state.eof() && is_identifier_char(state.peek())) {
-        value += state.advance();
-    }
+    // The whole span is scanned in one pass; no per-character appends
+    const size_t end = char_scan::skip_identifier(state.source, state.pos);
+    std::string value(state.source.substr(start_pos, end - start_pos));
+    state.advance_run(end);
 
     tok.length = static_cast<uint16_t>(state.pos - start_pos);
     tok.original_hash = hash_string(value);
@@ -443,9 +455,7 @@ void CppNormalizer::skip_preprocessor(TokenizerState& state) {
 }
 
 void CppNormalizer::skip_single_line_comment(TokenizerState& state) {
-    while (!state.eof() && state.peek() != '\n') {
-        state.advance();
-    }
+    state.advance_run(char_scan::find_char(state.source, state.pos, '\n'));
 }
 
 void CppNormalizer::skip_multi_line_comment(TokenizerState& state) {
@@ -453,6 +463,13 @@ void CppNormalizer::skip_multi_line_comment(TokenizerState& state) {
     state.advance();  // Skip *
 
     while (!state.eof()) {
+        // Bulk-skip the comment body; newlines stay per-character so
+        // line tracking in advance() still runs
+        state.advance_run(char_scan::find_any(
+            state.source, state.pos, '*', '\n', '\n'
+        ));
+        if (state.eof()) break;
+
         if (state.peek() == '*' && state.peek_next() == '/') {
             state.advance();
             state.advance();
@@ -516,9 +533,14 @@ void CppNormalizer::handle_line_metrics(TokenizerState& state, uint32_t& current
 
 bool CppNormalizer::skip_whitespace_and_newline(TokenizerState& state) {
     char c = state.peek();
-    
-    // Whitespace
-    if (c == ' ' || c == '\t' || c == '\r') {
+
+    // Whitespace: runs of ' '/'\t' bulk-skip and keep at_line_start;
+    // '\r' stays per-character because advance() clears the flag for it
+    if (c == ' ' || c == '\t') {
+        state.advance_run(char_scan::skip_spaces(state.source, state.pos), true);
+        return true;
+    }
+    if (c == '\r') {
         state.advance();
         return true;
     }
@@ -85,6 +85,17 @@ private:
             }
             return c;
         }
+        // Bulk-advance to a scanned position; the skipped run must not
+        // contain a newline (see char_scan.hpp stop-character contract).
+        // Pass spaces_only for runs of ' '/'\t', which keep at_line_start
+        // exactly as advance() would
+        void advance_run(size_t end, bool spaces_only = false) {
+            if (end > pos && !spaces_only) {
+                at_line_start = false;
+            }
+            column = static_cast<uint16_t>(column + (end - pos));
+            pos = end;
+        }
     };
 
     // Token parsing methods
@@ -1,4 +1,5 @@
 #include "tokenizers/js_normalizer.hpp"
+#include "tokenizers/char_scan.hpp"
 #include <cctype>
 #include <algorithm>
 
@@ -84,7 +85,7 @@ void JavaScriptNormalizer::update_line_metrics(TokenizerState& state, LineMetric
 
 bool JavaScriptNormalizer::skip_whitespace(TokenizerState& state, char c) {
     if (c == ' ' || c == '\t' || c == '\r') {
-        state.advance();
+        state.advance_run(char_scan::skip_spaces(state.source, state.pos, true));
         return true;
     }
     return false;
@@ -231,6 +232,17 @@ NormalizedToken JavaScriptNormalizer::parse_string(TokenizerState& state) {
     const size_t start_pos = state.pos;
 
     while (!state.eof()) {
+        // Bulk-copy the plain body up to the next character that needs
+        // a decision (closing quote, escape, or newline)
+        const size_t next = char_scan::find_any(
+            state.source, state.pos, quote, '\\', '\n'
+        );
+        if (next > state.pos) {
+            value.append(state.source.substr(state.pos, next - state.pos));
+            state.advance_run(next);
+            if (state.eof()) break;
+        }
+
         char c = state.peek();
 
         if (c == quote) {
@@ -454,12 +466,12 @@ NormalizedToken JavaScriptNormalizer::parse_identifier_or_keyword(TokenizerState
     tok.line = state.line;
     tok.column = state.column;
 
-    std::string value;
     const size_t start_pos = state.pos;
 
-    while (!state.eof() && is_identifier_char(state.peek())) {
-        value += state.advance();
-    }
+    // The whole span is scanned in one pass; no per-character appends
+    const size_t end = char_scan::skip_identifier(state.source, state.pos, true);
+    std::string value(state.source.substr(start_pos, end - start_pos));
+    state.advance_run(end);
 
     tok.length = static_cast<uint16_t>(state.pos - start_pos);
     tok.original_hash = hash_string(value);
@@ -568,9 +580,7 @@ NormalizedToken JavaScriptNormalizer::parse_regex(TokenizerState& state) const
 }
 
 void JavaScriptNormalizer::skip_single_line_comment(TokenizerState& state) {
-    while (!state.eof() && state.peek() != '\n') {
-        state.advance();
-    }
+    state.advance_run(char_scan::find_char(state.source, state.pos, '\n'));
 }
 
 void JavaScriptNormalizer::skip_multi_line_comment(TokenizerState& state) {
@@ -578,6 +588,13 @@ void JavaScriptNormalizer::skip_multi_line_comment(TokenizerState& state) {
     state.advance();  // Skip *
 
     while (!state.eof()) {
+        // Bulk-skip the comment body; newlines stay per-character so
+        // line tracking in advance() still runs
+        state.advance_run(char_scan::find_any(
+            state.source, state.pos, '*', '\n', '\n'
+        ));
+        if (state.eof()) break;
+
         if (state.peek() == '*' && state.peek_next() == '/') {
             state.advance();
             state.advance();
@@ -83,6 +83,12 @@ private:
             }
             return c;
         }
+        // Bulk-advance to a scanned position; the skipped run must not
+        // contain a newline (see char_scan.hpp stop-character contract)
+        void advance_run(size_t end) {
+            column = static_cast<uint16_t>(column + (end - pos));
+            pos = end;
+        }
     };
 
     // Token parsing methods
@@ -1,6 +1,7 @@
 #include "tokenizers/python_normalizer.hpp"
 #include "tokenizers/js_normalizer.hpp"
 #include "tokenizers/cpp_normalizer.hpp"
+#include "tokenizers/char_scan.hpp"
 #include <cctype>
 #include <algorithm>
 
@@ -113,6 +114,17 @@ NormalizedToken PythonNormalizer::parse_string(TokenizerState& state) {
     size_t start_pos = state.pos;
 
     while (!state.eof()) {
+        // Bulk-copy the plain body up to the next character that needs
+        // a decision (closing quote, escape, or newline)
+        const size_t next = char_scan::find_any(
+            state.source, state.pos, quote, '\\', '\n'
+        );
+        if (next > state.pos) {
+            value.append(state.source.substr(state.pos, next - state.pos));
+            state.advance_run(next);
+            if (state.eof()) break;
+        }
+
         char c = state.peek();
 
         if (triple) {
@@ -288,12 +300,12 @@ NormalizedToken PythonNormalizer::parse_identifier_or_keyword(TokenizerState& st
     tok.line = state.line;
     tok.column = state.column;
 
-    std::string value;
     size_t start_pos = state.pos;
 
-    while (!state.eof() && is_identifier_char(state.peek())) {
-        value += state.advance();
-    }
+    // The whole span is scanned in one pass; no per-character appends
+    const size_t end = char_scan::skip_identifier(state.source, state.pos);
+    std::string value(state.source.substr(start_pos, end - start_pos));
+    state.advance_run(end);
 
     tok.length = static_cast<uint16_t>(state.pos - start_pos);
     tok.original_hash = hash_string(value);
@@ -387,9 +399,7 @@ NormalizedToken PythonNormalizer::parse_operator(TokenizerState& state) {
 }
 
 void PythonNormalizer::skip_comment(TokenizerState& state) {
-    while (!state.eof() && state.peek() != '\n') {
-        state.advance();
-    }
+    state.advance_run(char_scan::find_char(state.source, state.pos, '\n'));
 }
 
 void PythonNormalizer::skip_docstring(TokenizerState& state, char quote) {
@@ -400,6 +410,13 @@ void PythonNormalizer::skip_docstring(TokenizerState& state, char quote) {
 
     // Skip until we find the closing triple quotes
     while (!state.eof()) {
+        // Bulk-skip plain body; newlines stay per-character so line
+        // tracking in advance() still runs
+        state.advance_run(char_scan::find_any(
+            state.source, state.pos, quote, '\\', '\n'
+        ));
+        if (state.eof()) break;
+
         char c = state.peek();
 
         // Check for closing triple quotes
@@ -482,6 +499,12 @@ bool PythonNormalizer::is_import_statement(const TokenizerState& state) const {
 void PythonNormalizer::skip_to_end_of_line(TokenizerState& state) {
     // Skip everything until newline (handles multi-line imports with backslash)
     while (!state.eof()) {
+        // Bulk-skip to the next newline, continuation, or paren group
+        state.advance_run(char_scan::find_any(
+            state.source, state.pos, '\n', '\\', '('
+        ));
+        if (state.eof()) return;
+
         char c = state.peek();
 
         if (c == '\n') {
@@ -575,7 +598,7 @@ void PythonNormalizer::update_line_metrics(TokenizerState& state, LineMetrics& m
 
 bool PythonNormalizer::skip_whitespace(TokenizerState& state, char c) {
     if (c == ' ' || c == '\t') {
-        state.advance();
+        state.advance_run(char_scan::skip_spaces(state.source, state.pos));
         return true;
     }
     return false;
@@ -89,6 +89,12 @@ private:
             }
             return c;
         }
+        // Bulk-advance to a scanned position; the skipped run must not
+        // contain a newline (see char_scan.hpp stop-character contract)
+        void advance_run(size_t end) {
+            column = static_cast<uint16_t>(column + (end - pos));
+            pos = end;
+        }
         void skip_whitespace_on_line() {
             while (!eof() && (peek() == ' ' || peek() == '\t')) {
                 advance();
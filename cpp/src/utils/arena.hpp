@@ -0,0 +1,105 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace aegis::similarity {
+
+/**
+ * A simple bump-pointer arena allocator.
+ *
+ * Serves allocations out of large blocks so that per-analysis data
+ * structures (token columns, location buffers) cost one large allocation
+ * per block instead of one heap allocation per file. Individual
+ * allocations are never freed; all memory is released when the arena
+ * is destroyed or reset.
+ *
+ * Not thread-safe: each analysis owns its arena.
+ */
+class Arena {
+public:
+    // Default block size; allocations larger than this get a dedicated block
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 1 << 20;  // 1 MiB
+
+    explicit Arena(size_t block_size = DEFAULT_BLOCK_SIZE)
+        : block_size_(block_size)
+    {
+    }
+
+    // Non-copyable (owns raw memory handed out to callers)
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    Arena(Arena&&) = default;
+    Arena& operator=(Arena&&) = default;
+
+    /**
+     * Allocate an uninitialized array of `count` elements of type T.
+     *
+     * T must be trivially destructible — the arena never runs destructors.
+     *
+     * @return Pointer to the array (nullptr only for count == 0)
+     */
+    template<typename T>
+    T* allocate(size_t count) {
+        static_assert(std::is_trivially_destructible_v<T>,
+                      "Arena never runs destructors");
+        if (count == 0) {
+            return nullptr;
+        }
+
+        const size_t bytes = count * sizeof(T);
+        return static_cast<T*>(allocate_bytes(bytes, alignof(T)));
+    }
+
+    /**
+     * Total bytes handed out (excluding block slack).
+     */
+    size_t bytes_allocated() const { return bytes_allocated_; }
+
+    /**
+     * Release all blocks. Invalidates every pointer handed out.
+     */
+    void reset() {
+        blocks_.clear();
+        current_ = nullptr;
+        remaining_ = 0;
+        bytes_allocated_ = 0;
+    }
+
+private:
+    void* allocate_bytes(size_t bytes, size_t alignment) {
+        // Align the bump pointer
+        const auto addr = reinterpret_cast<uintptr_t>(current_);
+        const size_t padding = addr ? (alignment - addr % alignment) % alignment : 0;
+
+        if (!current_ || padding + bytes > remaining_) {
+            // Oversized requests get their own block to avoid wasting slack
+            const size_t new_block_size = std::max(block_size_, bytes + alignment);
+            blocks_.push_back(std::make_unique<std::byte[]>(new_block_size));
+            current_ = blocks_.back().get();
+            remaining_ = new_block_size;
+            return allocate_bytes(bytes, alignment);
+        }
+
+        current_ += padding;
+        remaining_ -= padding;
+
+        void* result = current_;
+        current_ += bytes;
+        remaining_ -= bytes;
+        bytes_allocated_ += bytes;
+        return result;
+    }
+
+    size_t block_size_;
+    std::vector<std::unique_ptr<std::byte[]>> blocks_;
+    std::byte* current_ = nullptr;
+    size_t remaining_ = 0;
+    size_t bytes_allocated_ = 0;
+};
+
+}  // namespace aegis::similarity
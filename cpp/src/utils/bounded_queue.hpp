@@ -0,0 +1,83 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+namespace aegis::similarity {
+
+/**
+ * A blocking MPMC queue with a fixed capacity.
+ *
+ * Used to connect pipeline stages that run concurrently: producers
+ * block in push() while the queue is full, which keeps a fast upstream
+ * stage (e.g. directory discovery) from buffering unbounded work ahead
+ * of a slower downstream stage (e.g. tokenization). Consumers block in
+ * pop() until an item arrives or the queue is closed and drained.
+ */
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(const size_t capacity) : capacity_(capacity) {}
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    /**
+     * Enqueue an item, blocking while the queue is at capacity.
+     * Items pushed after close() are dropped.
+     */
+    void push(T value) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this] {
+            return items_.size() < capacity_ || closed_;
+        });
+        if (closed_) {
+            return;
+        }
+        items_.push_back(std::move(value));
+        not_empty_.notify_one();
+    }
+
+    /**
+     * Dequeue an item, blocking until one is available. Returns nullopt
+     * once the queue has been closed and fully drained.
+     */
+    std::optional<T> pop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] {
+            return !items_.empty() || closed_;
+        });
+        if (items_.empty()) {
+            return std::nullopt;
+        }
+        T value = std::move(items_.front());
+        items_.pop_front();
+        not_full_.notify_one();
+        return value;
+    }
+
+    /**
+     * Mark the end of the stream. Wakes all blocked producers and
+     * consumers; items already queued are still delivered.
+     */
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+
+private:
+    const size_t capacity_;
+    std::mutex mutex_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+    std::deque<T> items_;
+    bool closed_ = false;
+};
+
+}  // namespace aegis::similarity
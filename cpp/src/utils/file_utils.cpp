@@ -1,9 +1,99 @@
 #include "utils/file_utils.hpp"
+#include "utils/pattern_set.hpp"
 #include <algorithm>
-#include <regex>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace aegis::similarity {
 
+// =============================================================================
+// MappedFile
+// =============================================================================
+
+MappedFile::~MappedFile() {
+    if (data_) {
+        munmap(const_cast<char*>(data_), size_);
+    }
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(other.data_)
+    , size_(other.size_)
+    , fallback_(std::move(other.fallback_))
+{
+    other.data_ = nullptr;
+    other.size_ = 0;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        if (data_) {
+            munmap(const_cast<char*>(data_), size_);
+        }
+        data_ = other.data_;
+        size_ = other.size_;
+        fallback_ = std::move(other.fallback_);
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+    return *this;
+}
+
+std::optional<MappedFile> FileUtils::map_file(const std::filesystem::path& path) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return std::nullopt;
+    }
+
+    struct stat st{};
+    if (fstat(fd, &st) < 0 || !S_ISREG(st.st_mode)) {
+        close(fd);
+        return std::nullopt;
+    }
+
+    const auto size = static_cast<size_t>(st.st_size);
+
+    // Small files: buffered read is cheaper than a mapping
+    if (size < MMAP_THRESHOLD) {
+        close(fd);
+        auto contents = read_file(path);
+        if (!contents) {
+            return std::nullopt;
+        }
+        MappedFile file;
+        file.fallback_ = std::move(*contents);
+        return file;
+    }
+
+    void* addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  // Mapping stays valid after close
+
+    if (addr == MAP_FAILED) {
+        // Non-mappable filesystem (or mapping limit): fall back to a read
+        auto contents = read_file(path);
+        if (!contents) {
+            return std::nullopt;
+        }
+        MappedFile file;
+        file.fallback_ = std::move(*contents);
+        return file;
+    }
+
+    // Sequential scan hint for the tokenizers
+    madvise(addr, size, MADV_SEQUENTIAL);
+
+    MappedFile file;
+    file.data_ = static_cast<const char*>(addr);
+    file.size_ = size;
+    return file;
+}
+
 std::optional<std::string> FileUtils::read_file(const std::filesystem::path& path) {
     std::ifstream file(path, std::ios::binary);
     if (!file) {
@@ -35,6 +125,9 @@ std::vector<std::filesystem::path> FileUtils::find_files(
         return result;
     }
 
+    // Compile the exclusion globs once for the whole walk
+    const PatternSet excludes(exclude_patterns);
+
     try {
         for (const auto& entry : std::filesystem::recursive_directory_iterator(
             root,
@@ -52,7 +145,7 @@ std::vector<std::filesystem::path> FileUtils::find_files(
             }
 
             // Check exclusion patterns
-            if (auto rel_path = relative_path(path, root); matches_any_pattern(std::filesystem::path(rel_path), exclude_patterns)) {
+            if (excludes.matches(relative_path(path, root))) {
                 continue;
             }
 
@@ -69,68 +162,114 @@ std::vector<std::filesystem::path> FileUtils::find_files(
     return result;
 }
 
+void FileUtils::find_files_streaming(
+    const std::filesystem::path& root,
+    const std::vector<std::string>& extensions,
+    const std::vector<std::string>& exclude_patterns,
+    size_t num_walkers,
+    const std::function<void(std::filesystem::path)>& sink
+) {
+    if (!std::filesystem::exists(root) || !std::filesystem::is_directory(root)) {
+        return;
+    }
+
+    // Compile the exclusion globs once for the whole walk
+    const PatternSet excludes(exclude_patterns);
+
+    // Shared work list of directories still to scan. A walker takes one
+    // directory, lists it, pushes subdirectories back, and emits matching
+    // files. The walk is done when the list is empty and no walker is
+    // mid-directory.
+    std::mutex mutex;
+    std::condition_variable work_available;
+    std::deque<std::filesystem::path> pending;
+    size_t scanning = 0;
+
+    pending.push_back(root);
+
+    const auto walker = [&] {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            work_available.wait(lock, [&] {
+                return !pending.empty() || scanning == 0;
+            });
+            if (pending.empty()) {
+                return;  // No work left and nobody can produce more
+            }
+
+            auto dir = std::move(pending.front());
+            pending.pop_front();
+            ++scanning;
+            lock.unlock();
+
+            std::error_code ec;
+            std::filesystem::directory_iterator it(
+                dir,
+                std::filesystem::directory_options::skip_permission_denied,
+                ec
+            );
+            for (; !ec && it != std::filesystem::directory_iterator();
+                 it.increment(ec)) {
+                const auto& entry = *it;
+                std::error_code type_ec;
+
+                // Don't follow directory symlinks, matching the default
+                // recursive_directory_iterator behaviour of find_files()
+                if (entry.is_directory(type_ec) && !entry.is_symlink(type_ec)) {
+                    std::lock_guard<std::mutex> push_lock(mutex);
+                    pending.push_back(entry.path());
+                    work_available.notify_one();
+                    continue;
+                }
+
+                if (!entry.is_regular_file(type_ec)) {
+                    continue;
+                }
+
+                const auto& path = entry.path();
+                if (!has_allowed_extension(path, extensions)) {
+                    continue;
+                }
+                if (excludes.matches(relative_path(path, root))) {
+                    continue;
+                }
+
+                sink(path);
+            }
+
+            lock.lock();
+            --scanning;
+            if (pending.empty() && scanning == 0) {
+                work_available.notify_all();  // Release idle walkers
+            }
+        }
+    };
+
+    num_walkers = std::max<size_t>(num_walkers, 1);
+    std::vector<std::thread> walkers;
+    walkers.reserve(num_walkers);
+    for (size_t i = 0; i < num_walkers; ++i) {
+        walkers.emplace_back(walker);
+    }
+    for (auto& thread : walkers) {
+        thread.join();
+    }
+}
+
 bool FileUtils::matches_any_pattern(
     const std::filesystem::path& path,
     const std::vector<std::string>& patterns
 ) {
-    for (const auto& pattern : patterns) {
-        if (matches_pattern(path, pattern)) {
-            return true;
-        }
-    }
-    return false;
+    const PatternSet set(patterns);
+    return set.matches(path.generic_string());
 }
 
 bool FileUtils::matches_pattern(
     const std::filesystem::path& path,
     const std::string_view pattern
 ) {
-    const std::string path_str = path.generic_string();
-
-    // Convert glob pattern to regex
-    std::string regex_str;
-    regex_str.reserve(pattern.size() * 2);
-
-    size_t i = 0;
-    while (i < pattern.size()) {
-        char c = pattern[i];
-
-        if (c == '*') {
-            if (i + 1 < pattern.size() && pattern[i + 1] == '*') {
-                // ** matches any number of directories
-                regex_str += ".*";
-                i += 2;
-                // Skip the following /
-                if (i < pattern.size() && pattern[i] == '/') {
-                    i++;
-                }
-            } else {
-                // * matches anything except /
-                regex_str += "[^/]*";
-                i++;
-            }
-        } else if (c == '?') {
-            regex_str += "[^/]";
-            i++;
-        } else if (c == '.' || c == '[' || c == ']' || c == '(' || c == ')' ||
-                   c == '{' || c == '}' || c == '+' || c == '^' || c == '$' ||
-                   c == '|' || c == '\\') {
-            // Escape regex special characters
-            regex_str += '\\';
-            regex_str += c;
-            i++;
-        } else {
-            regex_str += c;
-            i++;
-        }
-    }
-
-    try {
-        const std::regex re(regex_str, std::regex::icase);
-        return std::regex_search(path_str, re);
-    } catch (const std::regex_error&) {
-        return false;
-    }
+    const auto compiled = PatternSet::compile(pattern);
+    return PatternSet::match_anywhere(compiled, path.generic_string());
 }
 
 std::string FileUtils::relative_path(
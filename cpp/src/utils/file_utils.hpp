@@ -4,12 +4,59 @@
 #include <string_view>
 #include <vector>
 #include <filesystem>
+#include <functional>
 #include <optional>
 #include <fstream>
 #include <sstream>
 
 namespace aegis::similarity {
 
+/**
+ * A file loaded for read-only access, preferably via mmap.
+ *
+ * Large files are memory-mapped so tokenizers consume a string_view over
+ * the kernel page cache with zero copies. Small files (where mmap setup
+ * overhead dominates) and files on non-mappable filesystems fall back to
+ * a regular buffered read. Either way, view() is valid for the lifetime
+ * of the object.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    // Move-only: the mapping is owned by exactly one instance
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /**
+     * Get a view over the file contents.
+     */
+    std::string_view view() const {
+        return data_ ? std::string_view(data_, size_) : std::string_view(fallback_);
+    }
+
+    /**
+     * Whether the contents are backed by an actual memory mapping
+     * (false when the buffered fallback path was used).
+     */
+    bool is_mapped() const { return data_ != nullptr; }
+
+    /**
+     * File size in bytes.
+     */
+    size_t size() const { return data_ ? size_ : fallback_.size(); }
+
+private:
+    friend class FileUtils;
+
+    const char* data_ = nullptr;  // mmap'd region (nullptr = fallback)
+    size_t size_ = 0;
+    std::string fallback_;        // buffered contents when not mapped
+};
+
 /**
  * Utility functions for file operations.
  */
@@ -23,6 +70,20 @@ public:
      */
     static std::optional<std::string> read_file(const std::filesystem::path& path);
 
+    /**
+     * Load a file for zero-copy access.
+     *
+     * Files of at least MMAP_THRESHOLD bytes are memory-mapped; smaller
+     * files and mmap failures fall back to read_file() transparently.
+     *
+     * @param path Path to the file
+     * @return Loaded file or nullopt if the file can't be read
+     */
+    static std::optional<MappedFile> map_file(const std::filesystem::path& path);
+
+    // Below this size the mmap/munmap syscall overhead exceeds the copy cost
+    static constexpr size_t MMAP_THRESHOLD = 16 * 1024;
+
     /**
      * Get file extension (including dot).
      */
@@ -42,9 +103,35 @@ public:
         const std::vector<std::string>& exclude_patterns = {}
     );
 
+    /**
+     * Streaming variant of find_files(): walks the tree with a small
+     * set of worker threads (one subdirectory at a time per worker) and
+     * hands each matching path to the sink as soon as it is found, so a
+     * downstream stage can start consuming while discovery is still
+     * running. Paths arrive in no particular order; the sink is invoked
+     * concurrently and must be thread-safe. Blocks until the walk is
+     * complete.
+     *
+     * @param root Root directory to search
+     * @param extensions File extensions to include (e.g., {".py", ".js"})
+     * @param exclude_patterns Glob patterns to exclude
+     * @param num_walkers Number of walker threads (clamped to >= 1)
+     * @param sink Thread-safe callback receiving each matching path
+     */
+    static void find_files_streaming(
+        const std::filesystem::path& root,
+        const std::vector<std::string>& extensions,
+        const std::vector<std::string>& exclude_patterns,
+        size_t num_walkers,
+        const std::function<void(std::filesystem::path)>& sink
+    );
+
     /**
      * Check if a path matches any of the exclusion patterns.
      *
+     * Convenience wrapper that compiles the patterns per call; callers
+     * matching many paths should build a PatternSet once instead.
+     *
      * Supports simple glob patterns:
      * - ** matches any number of directories
      * - * matches any sequence of characters in a single path component
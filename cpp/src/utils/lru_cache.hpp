@@ -1,11 +1,14 @@
 #pragma once
 
 #include <unordered_map>
+#include <algorithm>
 #include <list>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <functional>
 #include <cstddef>
+#include <vector>
 
 namespace aegis::similarity {
 
@@ -246,6 +249,240 @@ private:
     mutable size_t misses_ = 0;
 };
 
+/**
+ * Sharded, cost-aware LRU cache.
+ *
+ * Two differences from LRUCache for hot parallel paths:
+ *
+ * - Striped locking: keys hash to one of N independent segments, each
+ *   with its own mutex and LRU list, so concurrent workers only
+ *   contend when they touch the same shard rather than on one global
+ *   lock.
+ * - Cost-aware eviction: capacity is a cost budget (tokens, bytes —
+ *   whatever the cost function measures) split evenly across shards,
+ *   and each entry charges its actual cost. A huge value evicts many
+ *   small ones instead of counting as "one entry"; values costing more
+ *   than a whole shard's budget are not cached at all.
+ *
+ * @tparam Key The key type
+ * @tparam Value The value type
+ */
+template<typename Key, typename Value>
+class ShardedLRUCache {
+public:
+    /** Charge for one value against the budget. */
+    using CostFn = std::function<size_t(const Value&)>;
+
+    static constexpr size_t DEFAULT_SHARDS = 16;
+
+    /**
+     * Create a cache with the given total cost budget.
+     *
+     * @param cost_budget Total budget across all shards
+     * @param num_shards Number of independent segments
+     * @param cost Cost function; defaults to 1 per entry (plain LRU)
+     */
+    explicit ShardedLRUCache(
+        size_t cost_budget,
+        size_t num_shards = DEFAULT_SHARDS,
+        CostFn cost = [](const Value&) { return size_t{1}; }
+    )
+        : cost_(std::move(cost))
+        , budget_(cost_budget)
+    {
+        if (num_shards == 0) {
+            num_shards = 1;
+        }
+        shard_budget_ = std::max<size_t>(1, cost_budget / num_shards);
+        shards_.reserve(num_shards);
+        for (size_t i = 0; i < num_shards; ++i) {
+            shards_.push_back(std::make_unique<Shard>());
+        }
+    }
+
+    /**
+     * Get a value from the cache, marking it most recently used.
+     */
+    std::optional<Value> get(const Key& key) {
+        Shard& shard = shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto it = shard.map.find(key);
+        if (it == shard.map.end()) {
+            ++shard.misses;
+            return std::nullopt;
+        }
+
+        shard.list.splice(shard.list.begin(), shard.list, it->second);
+        ++shard.hits;
+        return it->second->value;
+    }
+
+    /**
+     * Insert or update a value, evicting least recently used entries
+     * from the key's shard until its cost fits.
+     */
+    void put(const Key& key, Value value) {
+        const size_t cost = cost_(value);
+        if (cost > shard_budget_) {
+            return;  // Would evict a whole shard for one entry
+        }
+
+        Shard& shard = shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        if (auto it = shard.map.find(key); it != shard.map.end()) {
+            shard.used -= it->second->cost;
+            it->second->value = std::move(value);
+            it->second->cost = cost;
+            shard.used += cost;
+            shard.list.splice(shard.list.begin(), shard.list, it->second);
+            return;
+        }
+
+        while (shard.used + cost > shard_budget_ && !shard.list.empty()) {
+            const auto& lru = shard.list.back();
+            shard.used -= lru.cost;
+            shard.map.erase(lru.key);
+            shard.list.pop_back();
+        }
+
+        shard.list.push_front(Entry{key, std::move(value), cost});
+        shard.map[key] = shard.list.begin();
+        shard.used += cost;
+    }
+
+    /**
+     * Check if a key exists (does not update access order).
+     */
+    bool contains(const Key& key) const {
+        const Shard& shard = shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.map.find(key) != shard.map.end();
+    }
+
+    /**
+     * Remove a key from the cache.
+     *
+     * @return true if the key was removed
+     */
+    bool remove(const Key& key) {
+        Shard& shard = shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto it = shard.map.find(key);
+        if (it == shard.map.end()) {
+            return false;
+        }
+        shard.used -= it->second->cost;
+        shard.list.erase(it->second);
+        shard.map.erase(it);
+        return true;
+    }
+
+    /**
+     * Clear all entries from every shard.
+     */
+    void clear() {
+        for (auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            shard->map.clear();
+            shard->list.clear();
+            shard->used = 0;
+        }
+    }
+
+    /**
+     * Get the current number of entries across all shards.
+     */
+    size_t size() const {
+        size_t total = 0;
+        for (const auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            total += shard->map.size();
+        }
+        return total;
+    }
+
+    /** Total cost budget. */
+    size_t capacity() const { return budget_; }
+
+    bool empty() const { return size() == 0; }
+
+    /**
+     * Cache statistics, aggregated over all shards.
+     */
+    struct Stats {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t current_size = 0;   // Entries
+        size_t cost_used = 0;      // Budget consumed
+        size_t capacity = 0;       // Total budget
+
+        [[nodiscard]] float hit_rate() const {
+            const size_t total = hits + misses;
+            return total > 0 ? static_cast<float>(hits) / static_cast<float>(total) : 0.0f;
+        }
+    };
+
+    Stats get_stats() const {
+        Stats stats;
+        stats.capacity = budget_;
+        for (const auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            stats.hits += shard->hits;
+            stats.misses += shard->misses;
+            stats.current_size += shard->map.size();
+            stats.cost_used += shard->used;
+        }
+        return stats;
+    }
+
+    void reset_stats() {
+        for (auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            shard->hits = 0;
+            shard->misses = 0;
+        }
+    }
+
+private:
+    struct Entry {
+        Key key;
+        Value value;
+        size_t cost;
+    };
+
+    struct Shard {
+        std::list<Entry> list;  // Front = most recently used
+        std::unordered_map<Key, typename std::list<Entry>::iterator> map;
+        size_t used = 0;
+        size_t hits = 0;
+        size_t misses = 0;
+        mutable std::mutex mutex;
+    };
+
+    Shard& shard_for(const Key& key) {
+        return *shards_[shard_index(key)];
+    }
+    const Shard& shard_for(const Key& key) const {
+        return *shards_[shard_index(key)];
+    }
+
+    size_t shard_index(const Key& key) const {
+        // Fold the high bits in so shard choice doesn't reuse the same
+        // low bits the shard's own hash map will use
+        size_t h = std::hash<Key>{}(key);
+        h ^= h >> 16;
+        return h % shards_.size();
+    }
+
+    CostFn cost_;
+    size_t budget_;
+    size_t shard_budget_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+};
+
 /**
  * Specialized cache for tokenized files.
  * Uses file modification time to invalidate entries.
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <sys/resource.h>
+
+namespace aegis::similarity {
+
+/**
+ * Process-wide instrumentation counters for the analysis hot paths.
+ *
+ * Counters are cumulative over the process lifetime and updated in
+ * bulk (once per file / per phase) with relaxed atomics, so the hot
+ * loops pay one uncontended fetch_add per batch rather than one per
+ * token. A dashboard scraping the server's `get_metrics` method while
+ * an analysis runs sees the counters advance live; rates (files/sec,
+ * tokens/sec) are derived by the scraper from successive snapshots.
+ */
+class AnalysisMetrics {
+public:
+    static AnalysisMetrics& global() {
+        static AnalysisMetrics instance;
+        return instance;
+    }
+
+    std::atomic<uint64_t> files_tokenized{0};
+    std::atomic<uint64_t> tokens_produced{0};
+    std::atomic<uint64_t> hashes_inserted{0};
+    std::atomic<uint64_t> candidate_pairs{0};   // Raw pairs out of the matcher
+    std::atomic<uint64_t> surviving_pairs{0};   // Pairs left after merge/filter
+    std::atomic<uint64_t> analyses_completed{0};
+
+    void add_files_tokenized(uint64_t n) {
+        files_tokenized.fetch_add(n, std::memory_order_relaxed);
+    }
+    void add_tokens_produced(uint64_t n) {
+        tokens_produced.fetch_add(n, std::memory_order_relaxed);
+    }
+    void add_hashes_inserted(uint64_t n) {
+        hashes_inserted.fetch_add(n, std::memory_order_relaxed);
+    }
+    void add_candidate_pairs(uint64_t n) {
+        candidate_pairs.fetch_add(n, std::memory_order_relaxed);
+    }
+    void add_surviving_pairs(uint64_t n) {
+        surviving_pairs.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    /**
+     * Consistent-enough point-in-time copy of all counters.
+     */
+    struct Snapshot {
+        uint64_t files_tokenized;
+        uint64_t tokens_produced;
+        uint64_t hashes_inserted;
+        uint64_t candidate_pairs;
+        uint64_t surviving_pairs;
+        uint64_t analyses_completed;
+        size_t peak_rss_bytes;
+    };
+
+    Snapshot snapshot() const {
+        return Snapshot{
+            files_tokenized.load(std::memory_order_relaxed),
+            tokens_produced.load(std::memory_order_relaxed),
+            hashes_inserted.load(std::memory_order_relaxed),
+            candidate_pairs.load(std::memory_order_relaxed),
+            surviving_pairs.load(std::memory_order_relaxed),
+            analyses_completed.load(std::memory_order_relaxed),
+            peak_rss_bytes()
+        };
+    }
+
+    /**
+     * Peak resident set size of this process, in bytes.
+     */
+    static size_t peak_rss_bytes() {
+        struct rusage usage{};
+        if (getrusage(RUSAGE_SELF, &usage) != 0) {
+            return 0;
+        }
+        // ru_maxrss is reported in kilobytes on Linux
+        return static_cast<size_t>(usage.ru_maxrss) * 1024;
+    }
+
+private:
+    AnalysisMetrics() = default;
+};
+
+}  // namespace aegis::similarity
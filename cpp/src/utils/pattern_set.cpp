@@ -0,0 +1,141 @@
+#include "utils/pattern_set.hpp"
+#include <cctype>
+
+namespace aegis::similarity {
+
+namespace {
+
+char to_lower(const char c) {
+    return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+}
+
+}  // anonymous namespace
+
+PatternSet::PatternSet(const std::vector<std::string>& patterns) {
+    patterns_.reserve(patterns.size());
+    for (const auto& pattern : patterns) {
+        patterns_.push_back(compile(pattern));
+    }
+}
+
+PatternSet::CompiledPattern PatternSet::compile(std::string_view pattern) {
+    CompiledPattern tokens;
+
+    size_t i = 0;
+    while (i < pattern.size()) {
+        const char c = pattern[i];
+
+        if (c == '*') {
+            if (i + 1 < pattern.size() && pattern[i + 1] == '*') {
+                tokens.push_back({TokenKind::GLOBSTAR, {}});
+                i += 2;
+                // Fold a directly following '/' into the globstar so
+                // '**/build/**' also matches a path starting at 'build/'
+                if (i < pattern.size() && pattern[i] == '/') {
+                    ++i;
+                }
+            } else {
+                tokens.push_back({TokenKind::STAR, {}});
+                ++i;
+            }
+        } else if (c == '?') {
+            tokens.push_back({TokenKind::QMARK, {}});
+            ++i;
+        } else {
+            // Accumulate a literal run (stored lowercased)
+            if (tokens.empty() || tokens.back().kind != TokenKind::LITERAL) {
+                tokens.push_back({TokenKind::LITERAL, {}});
+            }
+            tokens.back().literal += to_lower(c);
+            ++i;
+        }
+    }
+
+    return tokens;
+}
+
+bool PatternSet::match_tokens(
+    const CompiledPattern& tokens, const size_t token_idx,
+    const std::string_view path, const size_t pos
+) {
+    // Out of tokens: match is unanchored at the end, remainder is fine
+    if (token_idx == tokens.size()) {
+        return true;
+    }
+
+    const Token& token = tokens[token_idx];
+
+    switch (token.kind) {
+        case TokenKind::LITERAL: {
+            const auto& lit = token.literal;
+            if (pos + lit.size() > path.size()) {
+                return false;
+            }
+            for (size_t i = 0; i < lit.size(); ++i) {
+                if (to_lower(path[pos + i]) != lit[i]) {
+                    return false;
+                }
+            }
+            return match_tokens(tokens, token_idx + 1, path, pos + lit.size());
+        }
+
+        case TokenKind::QMARK:
+            if (pos >= path.size() || path[pos] == '/') {
+                return false;
+            }
+            return match_tokens(tokens, token_idx + 1, path, pos + 1);
+
+        case TokenKind::STAR: {
+            // Try every run length that stays within the component
+            for (size_t end = pos; ; ++end) {
+                if (match_tokens(tokens, token_idx + 1, path, end)) {
+                    return true;
+                }
+                if (end >= path.size() || path[end] == '/') {
+                    return false;
+                }
+            }
+        }
+
+        case TokenKind::GLOBSTAR: {
+            for (size_t end = pos; end <= path.size(); ++end) {
+                if (match_tokens(tokens, token_idx + 1, path, end)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+    }
+
+    return false;
+}
+
+bool PatternSet::match_anywhere(
+    const CompiledPattern& tokens,
+    const std::string_view path
+) {
+    // A leading globstar already tries every start position itself
+    if (!tokens.empty() && tokens.front().kind == TokenKind::GLOBSTAR) {
+        return match_tokens(tokens, 0, path, 0);
+    }
+
+    // Unanchored like the regex_search-based matcher: the pattern may
+    // start at any position in the path
+    for (size_t start = 0; start <= path.size(); ++start) {
+        if (match_tokens(tokens, 0, path, start)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PatternSet::matches(const std::string_view path) const {
+    for (const auto& pattern : patterns_) {
+        if (match_anywhere(pattern, path)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace aegis::similarity
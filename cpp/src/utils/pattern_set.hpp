@@ -0,0 +1,71 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace aegis::similarity {
+
+/**
+ * A set of glob exclusion patterns compiled once and matched many times.
+ *
+ * The previous implementation translated every glob to a regex string
+ * and constructed a std::regex per call — a directory walk over a large
+ * tree with ~15 exclude patterns built millions of regexes. PatternSet
+ * compiles each pattern into a flat token list at construction and
+ * matches with a small backtracking walk, no regex machinery involved.
+ *
+ * Semantics mirror the original matcher exactly:
+ * - `*` matches any run of characters within one path component
+ * - `?` matches a single character other than `/`
+ * - `**` matches across components; a directly following `/` is folded
+ *   into it, so the default excludes also match at the path root
+ * - matching is case-insensitive and unanchored (the pattern may match
+ *   any substring of the path)
+ */
+class PatternSet {
+public:
+    PatternSet() = default;
+
+    /**
+     * Compile a list of glob patterns.
+     */
+    explicit PatternSet(const std::vector<std::string>& patterns);
+
+    /**
+     * Check whether any pattern matches the path. Paths should use
+     * forward slashes (std::filesystem::path::generic_string form).
+     */
+    [[nodiscard]] bool matches(std::string_view path) const;
+
+    [[nodiscard]] bool empty() const { return patterns_.empty(); }
+    [[nodiscard]] size_t size() const { return patterns_.size(); }
+
+private:
+    enum class TokenKind : uint8_t {
+        LITERAL,   // Exact (case-insensitive) character run
+        STAR,      // Any run not crossing '/'
+        QMARK,     // One character other than '/'
+        GLOBSTAR   // Any run, including '/'
+    };
+
+    struct Token {
+        TokenKind kind;
+        std::string literal;  // Only for LITERAL
+    };
+
+    using CompiledPattern = std::vector<Token>;
+
+    static CompiledPattern compile(std::string_view pattern);
+    static bool match_tokens(
+        const CompiledPattern& tokens, size_t token_idx,
+        std::string_view path, size_t pos
+    );
+    static bool match_anywhere(const CompiledPattern& tokens, std::string_view path);
+
+    std::vector<CompiledPattern> patterns_;
+
+    friend class FileUtils;  // Single-pattern convenience path
+};
+
+}  // namespace aegis::similarity
@@ -0,0 +1,120 @@
+#include "utils/snippet_reader.hpp"
+#include <algorithm>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace aegis::similarity {
+
+namespace {
+
+// Line-offset scan granularity; snippets themselves are tiny, so this
+// only bounds the one-time indexing pass
+constexpr size_t SCAN_CHUNK_BYTES = 64 * 1024;
+
+}  // anonymous namespace
+
+SnippetReader::~SnippetReader() {
+    for (auto& [path, index] : files_) {
+        if (index.fd >= 0) {
+            close(index.fd);
+        }
+    }
+}
+
+const SnippetReader::FileIndex* SnippetReader::index_for(const std::string& path) {
+    auto it = files_.find(path);
+    if (it != files_.end()) {
+        return it->second.fd >= 0 ? &it->second : nullptr;
+    }
+
+    // Cache failures too (fd = -1) so a missing file is stat'd once
+    auto& index = files_[path];
+
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    struct stat st{};
+    if (fstat(fd, &st) < 0 || !S_ISREG(st.st_mode)) {
+        close(fd);
+        return nullptr;
+    }
+
+    // One sequential pass recording every line start; pread keeps the
+    // fd position untouched for the range reads that follow
+    index.line_offsets.push_back(0);
+    std::vector<char> chunk(SCAN_CHUNK_BYTES);
+    uint64_t offset = 0;
+    while (true) {
+        const ssize_t n = pread(fd, chunk.data(), chunk.size(), offset);
+        if (n < 0) {
+            close(fd);
+            index.line_offsets.clear();
+            return nullptr;
+        }
+        if (n == 0) break;
+
+        for (ssize_t i = 0; i < n; ++i) {
+            if (chunk[i] == '\n') {
+                index.line_offsets.push_back(offset + i + 1);
+            }
+        }
+        offset += static_cast<uint64_t>(n);
+    }
+
+    // Terminate with the file size so the last line has an end offset
+    if (index.line_offsets.back() != offset) {
+        index.line_offsets.push_back(offset);
+    }
+
+    index.fd = fd;
+    return &index;
+}
+
+std::string SnippetReader::read_lines(
+    const std::string& path,
+    uint32_t start_line,
+    uint32_t line_count
+) {
+    if (start_line == 0 || line_count == 0) {
+        return {};
+    }
+
+    const auto* index = index_for(path);
+    if (!index) {
+        return {};
+    }
+
+    // offsets has line_total + 1 entries (final entry = file size)
+    const size_t line_total = index->line_offsets.size() - 1;
+    if (start_line > line_total) {
+        return {};
+    }
+
+    const size_t first = start_line - 1;
+    const size_t last = std::min<size_t>(first + line_count, line_total);
+    const uint64_t begin = index->line_offsets[first];
+    const uint64_t end = index->line_offsets[last];
+
+    std::string text(end - begin, '\0');
+    size_t filled = 0;
+    while (filled < text.size()) {
+        const ssize_t n = pread(
+            index->fd, text.data() + filled, text.size() - filled,
+            begin + filled
+        );
+        if (n <= 0) {
+            return {};
+        }
+        filled += static_cast<size_t>(n);
+    }
+
+    if (!text.empty() && text.back() == '\n') {
+        text.pop_back();
+    }
+    return text;
+}
+
+}  // namespace aegis::similarity
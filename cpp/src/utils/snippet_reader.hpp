@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace aegis::similarity {
+
+/**
+ * Lazy line-range access to source files on disk.
+ *
+ * Report generation needs a few lines of source per clone location, but
+ * keeping every analyzed file's text resident just for that costs
+ * O(corpus) memory. SnippetReader instead touches a file only when a
+ * snippet is actually requested: on first access it scans the file once
+ * to record the byte offset of every line start, then each read_lines()
+ * call pread()s exactly the requested byte range. Memory scales with
+ * the files that clones reference, not with the corpus.
+ *
+ * Not thread-safe; report generation is single-threaded.
+ */
+class SnippetReader {
+public:
+    SnippetReader() = default;
+    ~SnippetReader();
+
+    // The per-file fds and offset tables are owned by one instance
+    SnippetReader(const SnippetReader&) = delete;
+    SnippetReader& operator=(const SnippetReader&) = delete;
+
+    /**
+     * Read `line_count` lines starting at 1-based `start_line`,
+     * trailing newline stripped. Returns an empty string if the file
+     * can't be read or start_line is past the end of the file; a range
+     * extending past the end is clamped.
+     */
+    std::string read_lines(
+        const std::string& path,
+        uint32_t start_line,
+        uint32_t line_count
+    );
+
+private:
+    struct FileIndex {
+        int fd = -1;
+        // Byte offset of each line start; back() is the file size, so
+        // line N (1-based) spans [offsets[N-1], offsets[N])
+        std::vector<uint64_t> line_offsets;
+    };
+
+    /**
+     * Open the file and build its line-offset table on first access;
+     * nullptr if the file can't be read.
+     */
+    const FileIndex* index_for(const std::string& path);
+
+    std::unordered_map<std::string, FileIndex> files_;
+};
+
+}  // namespace aegis::similarity
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace aegis::similarity {
+
+/**
+ * Append-only string interner: each distinct string is stored once and
+ * addressed by a dense uint32_t id thereafter.
+ *
+ * Backs the file-path registries, where the same path would otherwise
+ * be copied into every structure that mentions it. Ids are assigned in
+ * insertion order starting at 0, so they double as vector indices.
+ *
+ * Storage is a deque so string addresses stay stable as the table
+ * grows; the lookup map keys on views into that storage, making
+ * intern() allocation-free for strings already present.
+ */
+class StringInterner {
+public:
+    /**
+     * Get the id for a string, adding it to the table if new.
+     */
+    uint32_t intern(const std::string_view s) {
+        if (const auto it = ids_.find(s); it != ids_.end()) {
+            return it->second;
+        }
+        const auto id = static_cast<uint32_t>(strings_.size());
+        strings_.emplace_back(s);
+        ids_.emplace(strings_.back(), id);
+        return id;
+    }
+
+    /**
+     * Look up a string by id. Returns an empty string for unknown ids.
+     */
+    const std::string& at(const uint32_t id) const {
+        static const std::string empty;
+        return id < strings_.size() ? strings_[id] : empty;
+    }
+
+    [[nodiscard]] size_t size() const { return strings_.size(); }
+    [[nodiscard]] bool empty() const { return strings_.empty(); }
+
+    void clear() {
+        ids_.clear();
+        strings_.clear();
+    }
+
+private:
+    std::deque<std::string> strings_;  // Stable addresses back the map keys
+    std::unordered_map<std::string_view, uint32_t> ids_;
+};
+
+}  // namespace aegis::similarity
@@ -1,7 +1,7 @@
 #pragma once
 
 #include <vector>
-#include <queue>
+#include <deque>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
@@ -14,10 +14,13 @@
 namespace aegis::similarity {
 
 /**
- * A simple thread pool for parallel task execution.
+ * A work-stealing thread pool for parallel task execution.
  *
- * Provides efficient execution of tasks across multiple threads,
- * with automatic load balancing and synchronization.
+ * Each worker owns a deque: it pushes and pops work at the back (LIFO,
+ * cache-friendly) while idle workers steal from the front of other
+ * queues. This keeps skewed workloads balanced — one oversized task no
+ * longer strands the rest of a worker's statically assigned chunk —
+ * and removes the single submit-side mutex as a contention point.
  */
 class ThreadPool {
 public:
@@ -58,17 +61,11 @@ public:
 
         std::future<return_type> result = task->get_future();
 
-        {
-            std::unique_lock<std::mutex> lock(queue_mutex_);
-
-            if (stop_) {
-                throw std::runtime_error("Cannot submit to stopped ThreadPool");
-            }
-
-            tasks_.emplace([task]() { (*task)(); });
+        if (stop_) {
+            throw std::runtime_error("Cannot submit to stopped ThreadPool");
         }
 
-        condition_.notify_one();
+        push_task([task]() { (*task)(); });
         return result;
     }
 
@@ -94,25 +91,29 @@ public:
             return;
         }
 
-        // Divide work among threads
-        const size_t chunk_size = (num_tasks + num_workers - 1) / num_workers;
+        // Small grains claimed from a shared counter: fast workers keep
+        // pulling grains instead of idling behind a straggler's chunk
+        const size_t grain = std::max<size_t>(1, num_tasks / (num_workers * 8));
+        auto next = std::make_shared<std::atomic<size_t>>(begin);
+
         std::vector<std::future<void>> futures;
         futures.reserve(num_workers);
 
         for (size_t t = 0; t < num_workers; ++t) {
-            size_t chunk_begin = begin + t * chunk_size;
-            size_t chunk_end = std::min(chunk_begin + chunk_size, end);
-
-            if (chunk_begin >= end) break;
-
-            futures.push_back(submit([&f, chunk_begin, chunk_end]() {
-                for (size_t i = chunk_begin; i < chunk_end; ++i) {
-                    f(i);
+            futures.push_back(submit([&f, next, end, grain]() {
+                while (true) {
+                    const size_t chunk_begin = next->fetch_add(grain);
+                    if (chunk_begin >= end) break;
+
+                    const size_t chunk_end = std::min(chunk_begin + grain, end);
+                    for (size_t i = chunk_begin; i < chunk_end; ++i) {
+                        f(i);
+                    }
                 }
             }));
         }
 
-        // Wait for all chunks to complete
+        // Wait for all workers to drain the range
         for (auto& future : futures) {
             future.get();
         }
@@ -152,10 +153,7 @@ public:
     /**
      * Get the number of pending tasks.
      */
-    size_t pending() const {
-        std::unique_lock<std::mutex> lock(queue_mutex_);
-        return tasks_.size();
-    }
+    size_t pending() const { return pending_count_.load(); }
 
     /**
      * Wait for all pending tasks to complete.
@@ -163,20 +161,50 @@ public:
     void wait_all();
 
 private:
-    void worker_thread();
+    // One deque per worker; the owner works at the back, thieves take
+    // from the front
+    struct WorkerQueue {
+        std::deque<std::function<void()>> tasks;
+        std::mutex mutex;
+    };
+
+    void worker_thread(size_t worker_id);
+    void push_task(std::function<void()> task);
+    bool try_pop_task(size_t worker_id, std::function<void()>& task);
 
     std::vector<std::thread> workers_;
-    std::queue<std::function<void()>> tasks_;
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+
+    // Round-robin target for submissions from outside the pool
+    std::atomic<size_t> next_queue_{0};
 
-    mutable std::mutex queue_mutex_;
+    // Sleep/wake machinery; queues have their own fine-grained locks
+    std::mutex sleep_mutex_;
     std::condition_variable condition_;
     std::condition_variable completion_condition_;
     std::atomic<bool> stop_{false};
+    std::atomic<size_t> pending_count_{0};
     std::atomic<size_t> active_tasks_{0};
 };
 
 // Implementation
 
+namespace detail {
+
+// Identifies the pool (and worker slot) the current thread belongs to,
+// so submissions from worker threads go to their own queue
+struct WorkerIdentity {
+    const void* pool = nullptr;
+    size_t worker_id = 0;
+};
+
+inline WorkerIdentity& worker_identity() {
+    thread_local WorkerIdentity identity;
+    return identity;
+}
+
+}  // namespace detail
+
 inline ThreadPool::ThreadPool(size_t num_threads) {
     if (num_threads == 0) {
         num_threads = std::thread::hardware_concurrency();
@@ -185,15 +213,20 @@ inline ThreadPool::ThreadPool(size_t num_threads) {
         }
     }
 
+    queues_.reserve(num_threads);
+    for (size_t i = 0; i < num_threads; ++i) {
+        queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+
     workers_.reserve(num_threads);
     for (size_t i = 0; i < num_threads; ++i) {
-        workers_.emplace_back(&ThreadPool::worker_thread, this);
+        workers_.emplace_back(&ThreadPool::worker_thread, this, i);
     }
 }
 
 inline ThreadPool::~ThreadPool() {
     {
-        std::unique_lock<std::mutex> lock(queue_mutex_);
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
         stop_ = true;
     }
     condition_.notify_all();
@@ -205,41 +238,95 @@ inline ThreadPool::~ThreadPool() {
     }
 }
 
-inline void ThreadPool::worker_thread() {
-    while (true) {
-        std::function<void()> task;
+inline void ThreadPool::push_task(std::function<void()> task) {
+    // Worker threads push to their own queue's back; external threads
+    // spread submissions round-robin
+    const auto& identity = detail::worker_identity();
+    size_t target = identity.pool == this
+        ? identity.worker_id
+        : next_queue_.fetch_add(1) % queues_.size();
+
+    {
+        std::lock_guard<std::mutex> lock(queues_[target]->mutex);
+        queues_[target]->tasks.push_back(std::move(task));
+    }
 
-        {
-            std::unique_lock<std::mutex> lock(queue_mutex_);
-            condition_.wait(lock, [this] {
-                return stop_ || !tasks_.empty();
-            });
+    ++pending_count_;
 
-            if (stop_ && tasks_.empty()) {
-                return;
-            }
+    // Synchronize with a worker that may be between checking the wait
+    // predicate and sleeping; without this the notify could be missed
+    { std::lock_guard<std::mutex> lock(sleep_mutex_); }
+    condition_.notify_one();
+}
 
-            task = std::move(tasks_.front());
-            tasks_.pop();
-            ++active_tasks_;
+inline bool ThreadPool::try_pop_task(const size_t worker_id, std::function<void()>& task) {
+    // Own queue first: newest task at the back (still warm in cache)
+    {
+        auto& own = *queues_[worker_id];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
         }
+    }
+
+    // Steal from the front of the other queues (oldest task, least
+    // likely to be in the victim's cache)
+    for (size_t i = 1; i < queues_.size(); ++i) {
+        auto& victim = *queues_[(worker_id + i) % queues_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
 
-        task();
+inline void ThreadPool::worker_thread(const size_t worker_id) {
+    auto& identity = detail::worker_identity();
+    identity.pool = this;
+    identity.worker_id = worker_id;
+
+    while (true) {
+        std::function<void()> task;
+
+        if (try_pop_task(worker_id, task)) {
+            // Active before pending drops: wait_all() checks
+            // pending == 0 && active == 0, and the reverse order opens
+            // a window where both counters read zero with this task
+            // popped but not yet run
+            ++active_tasks_;
+            --pending_count_;
+
+            task();
 
-        {
-            std::unique_lock<std::mutex> lock(queue_mutex_);
             --active_tasks_;
-            if (active_tasks_ == 0 && tasks_.empty()) {
+            if (pending_count_ == 0 && active_tasks_ == 0) {
+                std::lock_guard<std::mutex> lock(sleep_mutex_);
                 completion_condition_.notify_all();
             }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        condition_.wait(lock, [this] {
+            return stop_ || pending_count_ > 0;
+        });
+
+        if (stop_ && pending_count_ == 0) {
+            return;
         }
     }
 }
 
 inline void ThreadPool::wait_all() {
-    std::unique_lock<std::mutex> lock(queue_mutex_);
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
     completion_condition_.wait(lock, [this] {
-        return tasks_.empty() && active_tasks_ == 0;
+        return pending_count_ == 0 && active_tasks_ == 0;
     });
 }
 
@@ -2,6 +2,7 @@
 #include "core/similarity_detector.hpp"
 #include "tokenizers/python_normalizer.hpp"
 #include "utils/file_utils.hpp"
+#include "utils/metrics.hpp"
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -528,3 +529,266 @@ TEST_F(SimilarityDetectorTest, Type3ExtendsClonesWithGaps) {
     EXPECT_EQ(report_with.summary.files_analyzed, 2);
 }
 
+
+TEST_F(SimilarityDetectorTest, ReportCarriesHotPathInstrumentation) {
+    if (!has_fixtures()) {
+        GTEST_SKIP() << "Fixtures directory not found";
+    }
+
+    auto file1 = fixtures_dir / "clone_type1_a.py";
+    auto file2 = fixtures_dir / "clone_type1_b.py";
+    if (!std::filesystem::exists(file1) || !std::filesystem::exists(file2)) {
+        GTEST_SKIP() << "Test fixtures not found";
+    }
+
+    const auto before = AnalysisMetrics::global().snapshot();
+
+    DetectorConfig config;
+    config.window_size = 5;
+    config.min_clone_tokens = 10;
+    config.extensions = {".py"};
+
+    SimilarityDetector detector(config);
+    auto report = detector.compare(file1, file2);
+
+    // Per-run counters in the performance block
+    EXPECT_GT(report.performance.hashes_inserted, 0u);
+    EXPECT_GE(report.performance.candidate_pairs, report.performance.surviving_pairs);
+    EXPECT_EQ(report.performance.surviving_pairs, report.clones.size());
+    EXPECT_GT(report.performance.peak_rss_bytes, 0u);
+
+    // Process-wide counters advanced
+    const auto after = AnalysisMetrics::global().snapshot();
+    EXPECT_GE(after.files_tokenized, before.files_tokenized + 2);
+    EXPECT_GT(after.tokens_produced, before.tokens_produced);
+    EXPECT_GT(after.hashes_inserted, before.hashes_inserted);
+    EXPECT_GT(after.analyses_completed, before.analyses_completed);
+}
+
+TEST_F(SimilarityDetectorTest, StreamedDirectoryAnalysisIsDeterministic) {
+    if (!has_fixtures()) {
+        GTEST_SKIP() << "Test fixtures not found";
+    }
+
+    DetectorConfig config;
+    config.window_size = 5;
+    config.min_clone_tokens = 10;
+    config.extensions = {".py"};
+
+    // Directory analysis streams discovery into tokenization; file_ids
+    // are assigned from path-sorted results, so repeated runs must
+    // produce identical reports despite nondeterministic arrival order
+    SimilarityDetector detector1(config);
+    auto first = detector1.analyze(fixtures_dir);
+
+    SimilarityDetector detector2(config);
+    auto second = detector2.analyze(fixtures_dir);
+
+    EXPECT_EQ(first.summary.files_analyzed, second.summary.files_analyzed);
+    EXPECT_EQ(first.file_table, second.file_table);
+    ASSERT_EQ(first.clones.size(), second.clones.size());
+    for (size_t i = 0; i < first.clones.size(); ++i) {
+        EXPECT_EQ(first.clones[i].id, second.clones[i].id);
+        EXPECT_EQ(first.clones[i].type, second.clones[i].type);
+        ASSERT_EQ(first.clones[i].locations.size(), second.clones[i].locations.size());
+        for (size_t j = 0; j < first.clones[i].locations.size(); ++j) {
+            EXPECT_EQ(first.clones[i].locations[j].file_id, second.clones[i].locations[j].file_id);
+            EXPECT_EQ(first.clones[i].locations[j].start_line, second.clones[i].locations[j].start_line);
+        }
+    }
+}
+
+TEST_F(SimilarityDetectorTest, ProgressiveAnalyzeReportsPhasesAndCandidates) {
+    if (!has_fixtures()) {
+        GTEST_SKIP() << "Test fixtures not found";
+    }
+
+    DetectorConfig config;
+    config.window_size = 5;
+    config.min_clone_tokens = 10;
+    config.extensions = {".py"};
+
+    size_t tokenized_calls = 0;
+    std::vector<std::string> progress_file_table;
+    size_t progress_tokens = 0;
+    size_t indexed_calls = 0;
+    size_t indexed_locations = 0;
+    size_t candidates_seen = 0;
+
+    AnalysisProgress progress;
+    progress.on_tokenized = [&](const std::vector<std::string>& file_table,
+                                const size_t total_tokens) {
+        tokenized_calls++;
+        progress_file_table = file_table;
+        progress_tokens = total_tokens;
+    };
+    progress.on_indexed = [&](size_t, const size_t locations) {
+        indexed_calls++;
+        indexed_locations = locations;
+    };
+    progress.on_candidates = [&](const std::vector<ClonePair>& pairs) {
+        candidates_seen += pairs.size();
+    };
+
+    SimilarityDetector detector(config);
+    const auto report = detector.analyze(fixtures_dir, progress);
+
+    // Each phase reported exactly once, consistent with the final report
+    EXPECT_EQ(tokenized_calls, 1u);
+    EXPECT_EQ(progress_file_table, report.file_table);
+    EXPECT_GT(progress_tokens, 0u);
+    EXPECT_EQ(indexed_calls, 1u);
+    EXPECT_GT(indexed_locations, 0u);
+
+    // Candidates are raw pre-merge pairs, so at least every merged
+    // clone in the final report was preceded by one
+    EXPECT_GE(candidates_seen, report.summary.clone_pairs_found);
+    if (report.summary.clone_pairs_found > 0) {
+        EXPECT_GT(candidates_seen, 0u);
+    }
+
+    // The progressive overload must not change the analysis itself
+    SimilarityDetector plain(config);
+    const auto baseline = plain.analyze(fixtures_dir);
+    EXPECT_EQ(report.summary.clone_pairs_found, baseline.summary.clone_pairs_found);
+    EXPECT_EQ(report.file_table, baseline.file_table);
+}
+
+TEST_F(SimilarityDetectorTest, IdenticalFilesReportedAsGroupNotClones) {
+    const auto dir = std::filesystem::temp_directory_path() / "aegis_dedup_test";
+    std::filesystem::create_directories(dir);
+
+    const std::string body =
+        "def process(items):\n"
+        "    total = 0\n"
+        "    for item in items:\n"
+        "        total += item.value\n"
+        "    return total\n";
+
+    for (const char* name : {"a.py", "b.py", "c.py"}) {
+        std::ofstream(dir / name) << body;
+    }
+    std::ofstream(dir / "other.py") << "import sys\n\nprint(sys.argv)\n";
+
+    DetectorConfig config;
+    config.window_size = 5;
+    config.min_clone_tokens = 10;
+    config.extensions = {".py"};
+
+    SimilarityDetector detector(config);
+    const auto report = detector.analyze(dir);
+
+    std::filesystem::remove_all(dir);
+
+    // All four files count toward totals, but the identical copies are
+    // reported as one group instead of pairwise clones
+    EXPECT_EQ(report.summary.files_analyzed, 4u);
+    ASSERT_EQ(report.identical_file_groups.size(), 1u);
+
+    const auto& group = report.identical_file_groups.front();
+    ASSERT_EQ(group.file_ids.size(), 3u);
+    EXPECT_EQ(group.line_count, 5u);
+
+    // Group paths are sorted and resolve through the file_table
+    std::vector<std::string> paths;
+    for (const auto id : group.file_ids) {
+        ASSERT_LT(id, report.file_table.size());
+        paths.push_back(report.file_table[id]);
+    }
+    EXPECT_TRUE(std::is_sorted(paths.begin(), paths.end()));
+    EXPECT_EQ(std::filesystem::path(paths.front()).filename(), "a.py");
+
+    // The copies never entered windowed matching
+    EXPECT_EQ(report.summary.clone_pairs_found, 0u);
+}
+
+TEST_F(SimilarityDetectorTest, MemoryBudgetSpillMatchesInMemoryReport) {
+    const auto dir = std::filesystem::temp_directory_path() / "aegis_spill_test";
+    std::filesystem::create_directories(dir);
+
+    // A corpus big enough that a 1 MB budget forces out-of-core
+    // matching: every file shares one cloned function and carries
+    // unique filler so the token count blows the budget
+    const std::string shared =
+        "def shared_logic(values):\n"
+        "    total = 0\n"
+        "    for value in values:\n"
+        "        if value > 0:\n"
+        "            total += value * 2\n"
+        "        else:\n"
+        "            total -= value\n"
+        "    return total\n";
+
+    for (int f = 0; f < 30; ++f) {
+        std::ofstream out(dir / ("file_" + std::to_string(f) + ".py"));
+        out << shared << "\n";
+        for (int i = 0; i < 100; ++i) {
+            out << "unique_" << f << "_" << i << " = " << (f * 1000 + i) << "\n";
+        }
+    }
+
+    DetectorConfig config;
+    config.window_size = 5;
+    config.min_clone_tokens = 10;
+    config.extensions = {".py"};
+
+    SimilarityDetector in_memory(config);
+    const auto baseline = in_memory.analyze(dir);
+
+    config.max_memory_mb = 1;
+    SimilarityDetector budgeted(config);
+    const auto spilled = budgeted.analyze(dir);
+
+    std::filesystem::remove_all(dir);
+
+    ASSERT_GT(baseline.summary.clone_pairs_found, 0u);
+
+    // Hash-range partitioning keeps all locations of a hash together,
+    // so the out-of-core scan must reproduce the in-memory result
+    EXPECT_EQ(spilled.summary.clone_pairs_found, baseline.summary.clone_pairs_found);
+    EXPECT_EQ(spilled.summary.files_analyzed, baseline.summary.files_analyzed);
+    EXPECT_EQ(spilled.summary.total_lines, baseline.summary.total_lines);
+    EXPECT_EQ(spilled.file_table, baseline.file_table);
+    ASSERT_EQ(spilled.clones.size(), baseline.clones.size());
+    for (size_t i = 0; i < spilled.clones.size(); ++i) {
+        EXPECT_EQ(spilled.clones[i].type, baseline.clones[i].type);
+        EXPECT_FLOAT_EQ(spilled.clones[i].similarity, baseline.clones[i].similarity);
+    }
+}
+
+TEST_F(SimilarityDetectorTest, SnippetPreviewsAreReadLazilyFromDisk) {
+    const auto dir = std::filesystem::temp_directory_path() / "aegis_snippet_test";
+    std::filesystem::create_directories(dir);
+
+    const std::string shared =
+        "def shared_logic(values):\n"
+        "    total = 0\n"
+        "    for value in values:\n"
+        "        total += value * 2\n"
+        "    return total\n";
+
+    // Distinct trailers so content dedup keeps both files as a pair
+    std::ofstream(dir / "first.py") << shared << "\nmarker_a = 1\n";
+    std::ofstream(dir / "second.py") << shared << "\nmarker_b = 2\n";
+
+    DetectorConfig config;
+    config.window_size = 5;
+    config.min_clone_tokens = 10;
+    config.extensions = {".py"};
+
+    SimilarityDetector detector(config);
+    const auto report = detector.analyze(dir);
+
+    std::filesystem::remove_all(dir);
+
+    // Source text is dropped after tokenization; previews must still
+    // come back with the real lines, re-read from disk at report time
+    ASSERT_GT(report.clones.size(), 0u);
+    for (const auto& clone : report.clones) {
+        for (const auto& loc : clone.locations) {
+            EXPECT_NE(loc.snippet_preview, "...");
+            EXPECT_NE(loc.snippet_preview.find("def shared_logic"),
+                      std::string::npos);
+        }
+    }
+}
@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+#include "core/federated_index.hpp"
+#include "core/index_store.hpp"
+#include "core/similarity_detector.hpp"
+#include <filesystem>
+#include <fstream>
+
+using namespace aegis::similarity;
+namespace fs = std::filesystem;
+
+namespace {
+
+// Enough duplicated logic to exceed min_clone_tokens with small windows
+const char* kSharedBody = R"(
+def process_records(records):
+    total = 0
+    for record in records:
+        if record.value > 0:
+            total += record.value * record.weight
+        else:
+            total -= record.penalty
+    average = total / len(records)
+    return average
+)";
+
+}  // anonymous namespace
+
+class FederatedIndexTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        root_ = fs::temp_directory_path() / "aegis_federated_test";
+        fs::remove_all(root_);
+        fs::create_directories(root_);
+    }
+
+    void TearDown() override {
+        fs::remove_all(root_);
+    }
+
+    void write_file(const fs::path& path, const std::string& content) {
+        fs::create_directories(path.parent_path());
+        std::ofstream out(path);
+        out << content;
+    }
+
+    // Analyze one "repo" directory and export its snapshot artifact,
+    // the way each repository's own CI would
+    fs::path export_artifact(const std::string& repo_name) {
+        const auto store_path = root_ / (repo_name + ".idx");
+
+        DetectorConfig config;
+        config.window_size = 5;
+        config.min_clone_tokens = 10;
+        config.extensions = {".py"};
+        config.incremental = true;
+        config.index_cache_path = store_path.string();
+
+        SimilarityDetector detector(config);
+        detector.analyze(root_ / repo_name);
+        return store_path;
+    }
+
+    fs::path root_;
+};
+
+TEST_F(FederatedIndexTest, FindsClonesAcrossArtifactsOnly) {
+    // repo_a carries an internal clone pair (shared.py twice, under
+    // different names with distinct trailers so dedup keeps both);
+    // repo_b shares the same function across the repo boundary
+    write_file(root_ / "repo_a" / "billing.py",
+               std::string(kSharedBody) + "\nmarker_a1 = 1\n");
+    write_file(root_ / "repo_a" / "invoices.py",
+               std::string(kSharedBody) + "\nmarker_a2 = 2\n");
+    write_file(root_ / "repo_a" / "unrelated.py", "import os\n\nprint(os.getcwd())\n");
+    write_file(root_ / "repo_b" / "reports.py",
+               std::string(kSharedBody) + "\nmarker_b = 3\n");
+
+    const auto store_a = export_artifact("repo_a");
+    const auto store_b = export_artifact("repo_b");
+
+    FederatedIndex::Config config;
+    config.min_clone_tokens = 10;
+    FederatedIndex federation(config);
+    ASSERT_TRUE(federation.add_artifact(store_a));
+    ASSERT_TRUE(federation.add_artifact(store_b));
+    EXPECT_EQ(federation.artifact_count(), 2u);
+
+    const auto clones = federation.find_cross_clones();
+    ASSERT_FALSE(clones.empty());
+
+    // Every reported pair crosses the artifact boundary; the intra-repo
+    // billing/invoices clone never appears
+    for (const auto& pair : clones) {
+        EXPECT_NE(federation.artifact_of(pair.location_a.file_id),
+                  federation.artifact_of(pair.location_b.file_id));
+
+        const auto& path_a = federation.index().get_file_path(pair.location_a.file_id);
+        const auto& path_b = federation.index().get_file_path(pair.location_b.file_id);
+        EXPECT_NE(path_a.find("repo_a") != std::string::npos,
+                  path_b.find("repo_a") != std::string::npos);
+    }
+}
+
+TEST_F(FederatedIndexTest, ArtifactBookkeepingTracksContributions) {
+    write_file(root_ / "repo_a" / "one.py", kSharedBody);
+    write_file(root_ / "repo_b" / "two.py",
+               std::string(kSharedBody) + "\nmarker = 1\n");
+
+    const auto store_a = export_artifact("repo_a");
+    const auto store_b = export_artifact("repo_b");
+
+    FederatedIndex federation;
+    ASSERT_TRUE(federation.add_artifact(store_a));
+    ASSERT_TRUE(federation.add_artifact(store_b));
+
+    const auto& artifacts = federation.artifacts();
+    ASSERT_EQ(artifacts.size(), 2u);
+    EXPECT_EQ(artifacts[0].source, store_a.string());
+    EXPECT_EQ(artifacts[0].file_count, 1u);
+    EXPECT_EQ(artifacts[1].file_count, 1u);
+    EXPECT_GT(artifacts[0].location_count, 0u);
+
+    // Every file resolves to the artifact that contributed it
+    EXPECT_EQ(federation.index().file_count(), 2u);
+    for (uint32_t id = 0; id < 2; ++id) {
+        const auto& path = federation.index().get_file_path(id);
+        const bool from_a = path.find("repo_a") != std::string::npos;
+        EXPECT_EQ(federation.artifact_of(id), from_a ? 0u : 1u);
+    }
+}
+
+TEST_F(FederatedIndexTest, MissingArtifactIsRejected) {
+    FederatedIndex federation;
+    EXPECT_FALSE(federation.add_artifact(root_ / "does_not_exist.idx"));
+    EXPECT_EQ(federation.artifact_count(), 0u);
+}
@@ -0,0 +1,326 @@
+#include <gtest/gtest.h>
+#include "utils/bounded_queue.hpp"
+#include "utils/file_utils.hpp"
+#include "utils/pattern_set.hpp"
+#include "utils/snippet_reader.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+using namespace aegis::similarity;
+
+class MappedFileTest : public ::testing::Test {
+protected:
+    std::filesystem::path temp_dir;
+
+    void SetUp() override {
+        temp_dir = std::filesystem::temp_directory_path() / "aegis_mapped_file_test";
+        std::filesystem::create_directories(temp_dir);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(temp_dir);
+    }
+
+    std::filesystem::path write_file(const std::string& name, const std::string& content) {
+        const auto path = temp_dir / name;
+        std::ofstream out(path, std::ios::binary);
+        out << content;
+        return path;
+    }
+};
+
+TEST_F(MappedFileTest, SmallFileUsesBufferedFallback) {
+    const auto path = write_file("small.py", "x = 1\n");
+
+    auto file = FileUtils::map_file(path);
+    ASSERT_TRUE(file.has_value());
+
+    EXPECT_FALSE(file->is_mapped());
+    EXPECT_EQ(file->view(), "x = 1\n");
+    EXPECT_EQ(file->size(), 6);
+}
+
+TEST_F(MappedFileTest, LargeFileIsMemoryMapped) {
+    // Above MMAP_THRESHOLD so the mmap path is taken
+    std::string content;
+    content.reserve(FileUtils::MMAP_THRESHOLD + 100);
+    while (content.size() <= FileUtils::MMAP_THRESHOLD) {
+        content += "def function_name():\n    return 42\n";
+    }
+    const auto path = write_file("large.py", content);
+
+    auto file = FileUtils::map_file(path);
+    ASSERT_TRUE(file.has_value());
+
+    EXPECT_TRUE(file->is_mapped());
+    EXPECT_EQ(file->size(), content.size());
+    EXPECT_EQ(file->view(), content);
+}
+
+TEST_F(MappedFileTest, ViewMatchesReadFile) {
+    const auto path = write_file("match.py", "a = 1\nb = 2\nc = a + b\n");
+
+    auto mapped = FileUtils::map_file(path);
+    auto contents = FileUtils::read_file(path);
+
+    ASSERT_TRUE(mapped.has_value());
+    ASSERT_TRUE(contents.has_value());
+    EXPECT_EQ(mapped->view(), *contents);
+}
+
+TEST_F(MappedFileTest, MissingFileReturnsNullopt) {
+    auto file = FileUtils::map_file(temp_dir / "does_not_exist.py");
+    EXPECT_FALSE(file.has_value());
+}
+
+TEST_F(MappedFileTest, MoveTransfersOwnership) {
+    std::string content(FileUtils::MMAP_THRESHOLD + 1, 'x');
+    const auto path = write_file("moved.py", content);
+
+    auto file = FileUtils::map_file(path);
+    ASSERT_TRUE(file.has_value());
+    ASSERT_TRUE(file->is_mapped());
+
+    MappedFile moved = std::move(*file);
+    EXPECT_TRUE(moved.is_mapped());
+    EXPECT_EQ(moved.view(), content);
+    EXPECT_FALSE(file->is_mapped());  // NOLINT: moved-from state is defined here
+}
+
+// =============================================================================
+// PatternSet (compiled glob matcher)
+// =============================================================================
+
+TEST(PatternSetTest, MatchesDefaultExcludeShapes) {
+    PatternSet set({
+        "**/node_modules/**",
+        "**/__pycache__/**",
+        "**/build/**"
+    });
+
+    EXPECT_TRUE(set.matches("project/node_modules/lodash/index.js"));
+    EXPECT_TRUE(set.matches("node_modules/lodash/index.js"));
+    EXPECT_TRUE(set.matches("src/__pycache__/models.cpython-312.pyc"));
+    EXPECT_TRUE(set.matches("build/CMakeFiles/core.dir/a.o"));
+
+    EXPECT_FALSE(set.matches("src/core/detector.py"));
+    EXPECT_FALSE(set.matches("lib/utils/helpers.js"));
+}
+
+TEST(PatternSetTest, StarStaysWithinComponent) {
+    PatternSet set({"src/*.py"});
+
+    EXPECT_TRUE(set.matches("src/main.py"));
+    EXPECT_FALSE(set.matches("src/sub/main.py"));
+}
+
+TEST(PatternSetTest, QuestionMarkMatchesSingleCharacter) {
+    PatternSet set({"file?.txt"});
+
+    EXPECT_TRUE(set.matches("file1.txt"));
+    EXPECT_TRUE(set.matches("fileA.txt"));
+    EXPECT_FALSE(set.matches("file.txt"));
+    EXPECT_FALSE(set.matches("file/x.txt"));
+}
+
+TEST(PatternSetTest, MatchingIsCaseInsensitive) {
+    PatternSet set({"**/Vendor/**"});
+
+    EXPECT_TRUE(set.matches("app/vendor/pkg/errors.go"));
+    EXPECT_TRUE(set.matches("app/VENDOR/pkg/errors.go"));
+}
+
+TEST(PatternSetTest, AgreesWithMatchesPattern) {
+    const std::vector<std::string> patterns = {
+        "**/node_modules/**",
+        "**/venv/**",
+        "*.tmp",
+        "tests/fixture?.py",
+        "**/cmake-build-*/**"
+    };
+    const std::vector<std::string> paths = {
+        "a/node_modules/b/c.js",
+        "venv/lib/site-packages/x.py",
+        "scratch.tmp",
+        "deep/scratch.tmp",
+        "tests/fixture1.py",
+        "tests/fixtures.py",
+        "proj/cmake-build-debug/obj/a.o",
+        "src/core/detector.py"
+    };
+
+    const PatternSet set(patterns);
+    for (const auto& path : paths) {
+        bool any = false;
+        for (const auto& pattern : patterns) {
+            any = any || FileUtils::matches_pattern(path, pattern);
+        }
+        EXPECT_EQ(set.matches(path), any) << "path: " << path;
+    }
+}
+
+class StreamingDiscoveryTest : public ::testing::Test {
+protected:
+    std::filesystem::path temp_dir;
+
+    void SetUp() override {
+        temp_dir = std::filesystem::temp_directory_path() / "aegis_streaming_test";
+        std::filesystem::remove_all(temp_dir);
+
+        // A small tree with nesting, an excluded directory, and files
+        // whose extensions must be filtered out
+        write_file("a.py");
+        write_file("b.js");
+        write_file("readme.md");
+        write_file("src/core/detector.py");
+        write_file("src/core/index.py");
+        write_file("src/utils/helpers.js");
+        write_file("node_modules/pkg/index.js");
+        write_file("deep/x/y/z/leaf.py");
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(temp_dir);
+    }
+
+    void write_file(const std::string& rel) {
+        const auto path = temp_dir / rel;
+        std::filesystem::create_directories(path.parent_path());
+        std::ofstream out(path);
+        out << "x = 1\n";
+    }
+};
+
+TEST_F(StreamingDiscoveryTest, FindsSameFilesAsFindFiles) {
+    const std::vector<std::string> extensions = {".py", ".js"};
+    const std::vector<std::string> excludes = {"**/node_modules/**"};
+
+    auto expected = FileUtils::find_files(temp_dir, extensions, excludes);
+    ASSERT_EQ(expected.size(), 6u);
+
+    std::mutex mutex;
+    std::vector<std::filesystem::path> streamed;
+    FileUtils::find_files_streaming(
+        temp_dir, extensions, excludes, 4,
+        [&](std::filesystem::path path) {
+            std::lock_guard<std::mutex> lock(mutex);
+            streamed.push_back(std::move(path));
+        }
+    );
+
+    // Streaming order is nondeterministic; the set of paths is not
+    std::sort(streamed.begin(), streamed.end());
+    EXPECT_EQ(streamed, expected);
+}
+
+TEST_F(StreamingDiscoveryTest, NonexistentRootEmitsNothing) {
+    size_t emitted = 0;
+    FileUtils::find_files_streaming(
+        temp_dir / "does_not_exist", {".py"}, {}, 2,
+        [&](std::filesystem::path) { ++emitted; }
+    );
+    EXPECT_EQ(emitted, 0u);
+}
+
+TEST(BoundedQueueTest, DeliversAllItemsAcrossThreads) {
+    BoundedQueue<int> queue(8);  // Far smaller than the item count
+    constexpr int ITEMS = 1000;
+
+    std::thread producer([&] {
+        for (int i = 0; i < ITEMS; ++i) {
+            queue.push(i);
+        }
+        queue.close();
+    });
+
+    std::mutex mutex;
+    std::vector<int> received;
+    std::vector<std::thread> consumers;
+    for (int t = 0; t < 3; ++t) {
+        consumers.emplace_back([&] {
+            while (auto item = queue.pop()) {
+                std::lock_guard<std::mutex> lock(mutex);
+                received.push_back(*item);
+            }
+        });
+    }
+
+    producer.join();
+    for (auto& consumer : consumers) {
+        consumer.join();
+    }
+
+    std::sort(received.begin(), received.end());
+    ASSERT_EQ(received.size(), static_cast<size_t>(ITEMS));
+    for (int i = 0; i < ITEMS; ++i) {
+        EXPECT_EQ(received[i], i);
+    }
+}
+
+TEST(BoundedQueueTest, PopReturnsNulloptAfterCloseAndDrain) {
+    BoundedQueue<int> queue(4);
+    queue.push(42);
+    queue.close();
+
+    auto first = queue.pop();
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(*first, 42);
+    EXPECT_FALSE(queue.pop().has_value());
+}
+
+// =============================================================================
+// SnippetReader
+// =============================================================================
+
+class SnippetReaderTest : public ::testing::Test {
+protected:
+    std::filesystem::path temp_dir;
+
+    void SetUp() override {
+        temp_dir = std::filesystem::temp_directory_path() / "aegis_snippet_reader_test";
+        std::filesystem::create_directories(temp_dir);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(temp_dir);
+    }
+
+    std::filesystem::path write_file(const std::string& name, const std::string& content) {
+        const auto path = temp_dir / name;
+        std::ofstream out(path, std::ios::binary);
+        out << content;
+        return path;
+    }
+};
+
+TEST_F(SnippetReaderTest, ReadsRequestedRange) {
+    const auto path = write_file("lines.py",
+        "line_one = 1\nline_two = 2\nline_three = 3\nline_four = 4\n");
+
+    SnippetReader reader;
+    EXPECT_EQ(reader.read_lines(path.string(), 2, 2), "line_two = 2\nline_three = 3");
+    EXPECT_EQ(reader.read_lines(path.string(), 1, 1), "line_one = 1");
+}
+
+TEST_F(SnippetReaderTest, RangePastEndIsClamped) {
+    const auto path = write_file("short.py", "only = 1\nlast = 2\n");
+
+    SnippetReader reader;
+    EXPECT_EQ(reader.read_lines(path.string(), 2, 10), "last = 2");
+    EXPECT_EQ(reader.read_lines(path.string(), 3, 1), "");
+}
+
+TEST_F(SnippetReaderTest, HandlesMissingTrailingNewline) {
+    const auto path = write_file("notrail.py", "first = 1\nsecond = 2");
+
+    SnippetReader reader;
+    EXPECT_EQ(reader.read_lines(path.string(), 2, 3), "second = 2");
+}
+
+TEST_F(SnippetReaderTest, MissingFileReturnsEmpty) {
+    SnippetReader reader;
+    EXPECT_EQ(reader.read_lines((temp_dir / "absent.py").string(), 1, 3), "");
+}
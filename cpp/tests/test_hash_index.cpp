@@ -1,7 +1,9 @@
 #include <gtest/gtest.h>
 #include "core/hash_index.hpp"
+#include "core/minhash.hpp"
 #include "core/rolling_hash.hpp"
 #include <chrono>
+#include <sstream>
 #include <iomanip>
 #include <iostream>
 
@@ -52,11 +54,10 @@ TEST_F(HashIndexTest, AddAndRetrieveHash) {
     HashLocation loc{0, 10, 15, 0, 50, 0, 10};
     index.add_hash(12345, loc);
 
-    auto* locations = index.get_locations(12345);
-    ASSERT_NE(locations, nullptr);
-    ASSERT_EQ(locations->size(), 1);
-    EXPECT_EQ((*locations)[0].file_id, 0);
-    EXPECT_EQ((*locations)[0].start_line, 10);
+    auto locations = index.get_locations(12345);
+    ASSERT_EQ(locations.size(), 1);
+    EXPECT_EQ(locations[0].file_id, 0);
+    EXPECT_EQ(locations[0].start_line, 10);
 }
 
 TEST_F(HashIndexTest, MultipleLocationsPerHash) {
@@ -68,13 +69,29 @@ TEST_F(HashIndexTest, MultipleLocationsPerHash) {
     index.add_hash(12345, loc2);
     index.add_hash(12345, loc3);
 
-    auto* locations = index.get_locations(12345);
-    ASSERT_NE(locations, nullptr);
-    EXPECT_EQ(locations->size(), 3);
+    auto locations = index.get_locations(12345);
+    EXPECT_EQ(locations.size(), 3);
 }
 
-TEST_F(HashIndexTest, NonexistentHashReturnsNull) {
-    EXPECT_EQ(index.get_locations(99999), nullptr);
+TEST_F(HashIndexTest, AddHashesBulkMatchesPerCallInsertion) {
+    HashLocation loc1{0, 1, 2, 0, 10, 0, 10};
+    HashLocation loc2{0, 5, 6, 0, 10, 20, 10};
+    HashLocation loc3{1, 1, 2, 0, 10, 0, 10};
+
+    const std::vector<uint64_t> hashes = {100, 100, 200};
+    const std::vector<HashLocation> locations = {loc1, loc2, loc3};
+    index.reserve(hashes.size());
+    index.add_hashes(hashes, locations);
+
+    EXPECT_EQ(index.location_count(), 3);
+    EXPECT_EQ(index.hash_count(), 2);
+    ASSERT_EQ(index.get_locations(100).size(), 2);
+    EXPECT_EQ(index.get_locations(200).size(), 1);
+    EXPECT_EQ(index.get_locations(200)[0].file_id, 1);
+}
+
+TEST_F(HashIndexTest, NonexistentHashReturnsEmpty) {
+    EXPECT_TRUE(index.get_locations(99999).empty());
 }
 
 TEST_F(HashIndexTest, ClearRemovesAllData) {
@@ -86,7 +103,121 @@ TEST_F(HashIndexTest, ClearRemovesAllData) {
 
     EXPECT_EQ(index.file_count(), 0);
     EXPECT_EQ(index.hash_count(), 0);
-    EXPECT_EQ(index.get_locations(12345), nullptr);
+    EXPECT_TRUE(index.get_locations(12345).empty());
+}
+
+TEST_F(HashIndexTest, MergeFromRemapsShardFileIds) {
+    // Simulate two build shards that registered the same files with
+    // different local ids
+    index.register_file("a.py");
+    index.register_file("b.py");
+
+    HashIndex shard;
+    uint32_t shard_b = shard.register_file("b.py");  // local id 0
+    HashLocation loc{shard_b, 1, 2, 0, 10, 0, 10};
+    shard.add_hash(42, loc);
+
+    index.merge_from(std::move(shard));
+
+    auto locations = index.get_locations(42);
+    ASSERT_EQ(locations.size(), 1);
+    EXPECT_EQ(locations[0].file_id, 1);  // remapped to "b.py" in the target
+    EXPECT_EQ(index.file_count(), 2);
+}
+
+TEST_F(HashIndexTest, QueriesStayConsistentAcrossInterleavedMutation) {
+    // The flat index rebuilds its bucket table lazily after mutations;
+    // interleave queries with adds/removes to exercise that path
+    HashLocation loc_a{0, 1, 2, 0, 10, 0, 10};
+    HashLocation loc_b{1, 5, 6, 0, 10, 0, 10};
+
+    index.add_hash(100, loc_a);
+    EXPECT_EQ(index.get_locations(100).size(), 1);
+
+    index.add_hash(100, loc_b);
+    index.add_hash(200, loc_b);
+    EXPECT_EQ(index.get_locations(100).size(), 2);
+    EXPECT_EQ(index.hash_count(), 2);
+
+    index.remove_file(1);
+    EXPECT_EQ(index.get_locations(100).size(), 1);
+    EXPECT_EQ(index.get_locations(100)[0].file_id, 0);
+    EXPECT_TRUE(index.get_locations(200).empty());
+}
+
+// =============================================================================
+// Snapshot Image Tests
+// =============================================================================
+
+TEST_F(HashIndexTest, SaveLoadRoundTripsImage) {
+    index.register_file("a.py");
+    index.register_file("b.py");
+
+    HashLocation loc_a{0, 1, 5, 0, 10, 0, 10};
+    HashLocation loc_b{1, 20, 24, 0, 10, 0, 10};
+    index.add_hash(100, loc_a);
+    index.add_hash(100, loc_b);
+    index.add_hash(200, loc_a);
+
+    std::stringstream buffer;
+    ASSERT_TRUE(index.save(buffer));
+
+    // The image lands in query-ready form: same registry, same buckets
+    HashIndex loaded;
+    ASSERT_TRUE(loaded.load(buffer));
+    EXPECT_EQ(loaded.file_count(), 2);
+    EXPECT_EQ(loaded.get_file_path(0), "a.py");
+    EXPECT_EQ(loaded.get_file_path(1), "b.py");
+    EXPECT_EQ(loaded.hash_count(), 2);
+    EXPECT_EQ(loaded.location_count(), 3);
+    ASSERT_EQ(loaded.get_locations(100).size(), 2);
+    EXPECT_EQ(loaded.get_locations(200).size(), 1);
+    EXPECT_EQ(loaded.get_locations(100)[0].start_line, 1);
+
+    // A loaded index must still accept mutations (incremental runs
+    // remove stale files before re-indexing)
+    loaded.remove_file(1);
+    ASSERT_EQ(loaded.get_locations(100).size(), 1);
+    EXPECT_EQ(loaded.get_locations(100)[0].file_id, 0);
+}
+
+TEST_F(HashIndexTest, SaveLoadEmptyIndex) {
+    std::stringstream buffer;
+    ASSERT_TRUE(index.save(buffer));
+
+    HashIndex loaded;
+    ASSERT_TRUE(loaded.load(buffer));
+    EXPECT_EQ(loaded.file_count(), 0);
+    EXPECT_EQ(loaded.location_count(), 0);
+    EXPECT_TRUE(loaded.get_locations(123).empty());
+}
+
+TEST_F(HashIndexTest, LoadRejectsCorruptImage) {
+    std::stringstream buffer("not a snapshot");
+    HashIndex loaded;
+    EXPECT_FALSE(loaded.load(buffer));
+    EXPECT_EQ(loaded.file_count(), 0);
+}
+
+TEST_F(HashIndexTest, LoadRejectsTruncatedImage) {
+    index.register_file("a.py");
+    HashLocation loc{0, 1, 5, 0, 10, 0, 10};
+    index.add_hash(100, loc);
+    index.add_hash(200, loc);
+
+    std::stringstream buffer;
+    ASSERT_TRUE(index.save(buffer));
+    const auto image = buffer.str();
+
+    // Cutting the image anywhere inside the tables must fail cleanly
+    // (the header claims locations the stream can no longer provide)
+    for (const size_t cut : {image.size() - 1, image.size() / 2}) {
+        std::stringstream truncated(image.substr(0, cut));
+        HashIndex loaded;
+        EXPECT_FALSE(loaded.load(truncated)) << "cut at " << cut;
+        EXPECT_EQ(loaded.file_count(), 0);
+        EXPECT_EQ(loaded.location_count(), 0);
+    }
 }
 
 // =============================================================================
@@ -175,6 +306,85 @@ TEST_F(HashIndexTest, FindClonePairsMultipleHashes) {
 // Merge Adjacent Clones Tests
 // =============================================================================
 
+// =============================================================================
+// Overlap Consolidation Tests
+// =============================================================================
+
+TEST_F(HashIndexTest, ConsolidateOverlapsEmpty) {
+    std::vector<ClonePair> pairs;
+    auto out = HashIndex::consolidate_overlaps(pairs);
+    EXPECT_TRUE(out.empty());
+}
+
+TEST_F(HashIndexTest, ConsolidateOverlapsUnionsDiagonalRun) {
+    // One real clone seen through sliding windows: five pairs on the
+    // same diagonal, each shifted by one token
+    std::vector<ClonePair> pairs;
+    for (uint32_t i = 0; i < 5; ++i) {
+        ClonePair pair;
+        pair.location_a = {0, 10 + i, 12 + i, 0, 50, i, 10};
+        pair.location_b = {1, 20 + i, 22 + i, 0, 50, 100 + i, 10};
+        pair.similarity = 1.0f;
+        pairs.push_back(pair);
+    }
+
+    auto out = HashIndex::consolidate_overlaps(std::move(pairs));
+    ASSERT_EQ(out.size(), 1);
+    EXPECT_EQ(out[0].location_a.token_start, 0);
+    EXPECT_EQ(out[0].location_a.token_count, 14);  // [0, 14) unioned
+    EXPECT_EQ(out[0].location_b.token_start, 100);
+    EXPECT_EQ(out[0].location_b.token_count, 14);
+    EXPECT_EQ(out[0].location_a.end_line, 16);
+}
+
+TEST_F(HashIndexTest, ConsolidateOverlapsDropsSubsumedPair) {
+    // A long surviving clone and a shorter pair fully inside it on a
+    // different diagonal (repeated code matching twice)
+    ClonePair big;
+    big.location_a = {0, 1, 20, 0, 50, 0, 100};
+    big.location_b = {1, 1, 20, 0, 50, 0, 100};
+
+    ClonePair inner;
+    inner.location_a = {0, 5, 8, 0, 50, 30, 10};
+    inner.location_b = {1, 10, 13, 0, 50, 60, 10};
+
+    std::vector<ClonePair> pairs = {inner, big};
+    auto out = HashIndex::consolidate_overlaps(std::move(pairs));
+    ASSERT_EQ(out.size(), 1);
+    EXPECT_EQ(out[0].location_a.token_count, 100);
+}
+
+TEST_F(HashIndexTest, ConsolidateOverlapsKeepsDistinctFilePairs) {
+    ClonePair pair1;
+    pair1.location_a = {0, 1, 5, 0, 50, 0, 10};
+    pair1.location_b = {1, 1, 5, 0, 50, 0, 10};
+
+    ClonePair pair2;
+    pair2.location_a = {0, 1, 5, 0, 50, 0, 10};
+    pair2.location_b = {2, 1, 5, 0, 50, 0, 10};
+
+    std::vector<ClonePair> pairs = {pair1, pair2};
+    auto out = HashIndex::consolidate_overlaps(std::move(pairs));
+    EXPECT_EQ(out.size(), 2);
+}
+
+TEST_F(HashIndexTest, ConsolidateOverlapsNormalizesOrientation) {
+    // Same region pair reported in both directions collapses to one
+    ClonePair forward;
+    forward.location_a = {0, 1, 5, 0, 50, 0, 10};
+    forward.location_b = {1, 1, 5, 0, 50, 0, 10};
+
+    ClonePair reversed;
+    reversed.location_a = {1, 1, 5, 0, 50, 0, 10};
+    reversed.location_b = {0, 1, 5, 0, 50, 0, 10};
+
+    std::vector<ClonePair> pairs = {forward, reversed};
+    auto out = HashIndex::consolidate_overlaps(std::move(pairs));
+    ASSERT_EQ(out.size(), 1);
+    EXPECT_EQ(out[0].location_a.file_id, 0);
+    EXPECT_EQ(out[0].location_b.file_id, 1);
+}
+
 TEST_F(HashIndexTest, MergeAdjacentClonesEmpty) {
     std::vector<ClonePair> empty;
     auto merged = HashIndex::merge_adjacent_clones(empty);
@@ -386,6 +596,61 @@ TEST(HashIndexBuilderTest, SmallFilesIgnored) {
     EXPECT_EQ(builder.index().hash_count(), 0);
 }
 
+TEST(HashIndexBuilderTest, ColumnsPathMatchesTokenPath) {
+    // The SoA overload must index exactly what the AoS overload does
+    TokenizedFile file;
+    file.path = "test.py";
+
+    for (int i = 0; i < 30; ++i) {
+        NormalizedToken tok;
+        tok.type = (i % 7 == 0) ? TokenType::NEWLINE : TokenType::IDENTIFIER;
+        tok.original_hash = static_cast<uint32_t>(i * 31);
+        tok.normalized_hash = static_cast<uint32_t>(i * 17);
+        tok.line = static_cast<uint32_t>(i + 1);
+        tok.column = static_cast<uint16_t>(i % 80);
+        tok.length = 4;
+        file.tokens.push_back(tok);
+    }
+
+    HashIndexBuilder aos_builder(5);
+    aos_builder.add_file(file, true);
+
+    Arena arena;
+    HashIndexBuilder soa_builder(5);
+    soa_builder.add_file(file.path, TokenColumns::from_tokens(file.tokens, arena), true);
+
+    const auto aos_stats = aos_builder.index().get_stats();
+    const auto soa_stats = soa_builder.index().get_stats();
+
+    EXPECT_EQ(aos_stats.total_files, soa_stats.total_files);
+    EXPECT_EQ(aos_stats.total_hashes, soa_stats.total_hashes);
+    EXPECT_EQ(aos_stats.total_locations, soa_stats.total_locations);
+}
+
+TEST(TokenColumnsTest, FromTokensCopiesAllFields) {
+    TokenizedFile file;
+    NormalizedToken tok;
+    tok.type = TokenType::KEYWORD;
+    tok.original_hash = 123;
+    tok.normalized_hash = 456;
+    tok.line = 7;
+    tok.column = 8;
+    tok.length = 9;
+    file.tokens.push_back(tok);
+
+    Arena arena;
+    auto cols = TokenColumns::from_tokens(file.tokens, arena);
+
+    ASSERT_EQ(cols.count, 1);
+    EXPECT_EQ(cols.types[0], TokenType::KEYWORD);
+    EXPECT_EQ(cols.original_hashes[0], 123u);
+    EXPECT_EQ(cols.normalized_hashes[0], 456u);
+    EXPECT_EQ(cols.lines[0], 7u);
+    EXPECT_EQ(cols.columns[0], 8);
+    EXPECT_EQ(cols.lengths[0], 9);
+    EXPECT_GT(arena.bytes_allocated(), 0);
+}
+
 // =============================================================================
 // Parallel Clone Pair Detection Tests
 // =============================================================================
@@ -597,6 +862,186 @@ TEST(HashIndexParallelTest, ParallelExcludesOverlappingSameFile) {
     EXPECT_EQ(parallel_pairs.size(), 400);
 }
 
+// =============================================================================
+// MinHash Sketch / LSH Pre-Filter Tests
+// =============================================================================
+
+TEST(RegionSketchTest, IdenticalRegionsSketchIdentically) {
+    std::vector<uint64_t> hashes;
+    for (uint64_t i = 0; i < 50; ++i) {
+        hashes.push_back(i * 0x9e3779b97f4a7c15ULL);
+    }
+
+    uint64_t a = RegionSketch::compute(hashes.data(), hashes.size());
+    uint64_t b = RegionSketch::compute(hashes.data(), hashes.size());
+
+    EXPECT_EQ(a, b);
+    EXPECT_FLOAT_EQ(RegionSketch::estimate_similarity(a, b), 1.0f);
+}
+
+TEST(RegionSketchTest, DisjointRegionsEstimateLowSimilarity) {
+    std::vector<uint64_t> first, second;
+    for (uint64_t i = 0; i < 50; ++i) {
+        first.push_back(1000 + i);
+        second.push_back(900000 + i);
+    }
+
+    uint64_t a = RegionSketch::compute(first.data(), first.size());
+    uint64_t b = RegionSketch::compute(second.data(), second.size());
+
+    // 4-bit slots collide by chance at ~1/16 per slot; disjoint regions
+    // should stay far below any reasonable similarity threshold
+    EXPECT_LT(RegionSketch::estimate_similarity(a, b), 0.5f);
+}
+
+TEST(RegionSketchTest, EmptyRegionSketchesToZero) {
+    EXPECT_EQ(RegionSketch::compute(nullptr, 0), 0u);
+}
+
+TEST_F(HashIndexTest, OversizedBucketFiltersUnrelatedContexts) {
+    // Build a bucket larger than the exact-pair limit (64) so pair
+    // generation goes through the LSH banding path
+    std::vector<uint64_t> shared_context;
+    for (uint64_t i = 0; i < 40; ++i) {
+        shared_context.push_back(777000 + i);
+    }
+    const uint64_t similar_sketch =
+        RegionSketch::compute(shared_context.data(), shared_context.size());
+
+    const uint64_t hash = 42424242;
+    uint32_t line = 1;
+
+    // 70 locations with matching context sketches across two files
+    for (size_t i = 0; i < 70; ++i) {
+        HashLocation loc{};
+        loc.file_id = index.register_file(
+            "similar" + std::to_string(i) + ".py");
+        loc.start_line = line;
+        loc.end_line = line + 5;
+        loc.token_start = 0;
+        loc.token_count = 10;
+        loc.context_sketch = similar_sketch;
+        index.add_hash(hash, loc);
+        line += 10;
+    }
+
+    // 30 locations whose surroundings share nothing with the rest
+    for (size_t i = 0; i < 30; ++i) {
+        std::vector<uint64_t> noise;
+        for (uint64_t j = 0; j < 40; ++j) {
+            noise.push_back((i + 1) * 100000 + j * 31);
+        }
+        HashLocation loc{};
+        loc.file_id = index.register_file(
+            "noise" + std::to_string(i) + ".py");
+        loc.start_line = line;
+        loc.end_line = line + 5;
+        loc.token_start = 0;
+        loc.token_count = 10;
+        loc.context_sketch = RegionSketch::compute(noise.data(), noise.size());
+        index.add_hash(hash, loc);
+        line += 10;
+    }
+
+    auto pairs = index.find_clone_pairs(1, 0.9f);
+
+    // All same-sketch pairs survive: 70 * 69 / 2
+    EXPECT_GE(pairs.size(), 70u * 69u / 2u);
+
+    // Pairs joining a similar-context location with an unrelated one
+    // must be filtered; allow a small margin for band collisions
+    const size_t all_pairs = 100u * 99u / 2u;
+    EXPECT_LT(pairs.size(), all_pairs * 3 / 4);
+}
+
+TEST_F(HashIndexTest, SmallBucketIgnoresSimilarityFloor) {
+    // At or below the exact-pair limit the quadratic path runs and
+    // sketches are not consulted, preserving exact-match semantics
+    uint32_t file1 = index.register_file("a.py");
+    uint32_t file2 = index.register_file("b.py");
+
+    HashLocation loc1{};
+    loc1.file_id = file1;
+    loc1.start_line = 1;
+    loc1.end_line = 5;
+    loc1.token_count = 10;
+    loc1.context_sketch = 0x1111111111111111ULL;
+
+    HashLocation loc2{};
+    loc2.file_id = file2;
+    loc2.start_line = 1;
+    loc2.end_line = 5;
+    loc2.token_count = 10;
+    loc2.context_sketch = 0x2222222222222222ULL;
+
+    index.add_hash(123, loc1);
+    index.add_hash(123, loc2);
+
+    auto pairs = index.find_clone_pairs(1, 0.9f);
+    EXPECT_EQ(pairs.size(), 1);
+}
+
+// =============================================================================
+// Hot-Hash Suppression Tests
+// =============================================================================
+
+TEST_F(HashIndexTest, HotHashSuppressionDropsOversizedBuckets) {
+    const uint64_t hot_hash = 111;
+    const uint64_t cold_hash = 222;
+
+    // 10 locations for the hot hash, 3 for the cold one
+    for (size_t i = 0; i < 10; ++i) {
+        HashLocation loc{};
+        loc.file_id = index.register_file("hot" + std::to_string(i) + ".py");
+        loc.start_line = 1;
+        loc.end_line = 5;
+        loc.token_count = 10;
+        index.add_hash(hot_hash, loc);
+    }
+    for (size_t i = 0; i < 3; ++i) {
+        HashLocation loc{};
+        loc.file_id = index.register_file("cold" + std::to_string(i) + ".py");
+        loc.start_line = 1;
+        loc.end_line = 5;
+        loc.token_count = 10;
+        index.add_hash(cold_hash, loc);
+    }
+
+    index.set_max_locations_per_hash(5);
+    auto pairs = index.find_clone_pairs();
+
+    // Only the cold hash generates pairs: 3 * 2 / 2
+    EXPECT_EQ(pairs.size(), 3u);
+    for (const auto& pair : pairs) {
+        EXPECT_EQ(pair.shared_hash, cold_hash);
+    }
+
+    auto stats = index.get_stats();
+    EXPECT_EQ(stats.suppressed_hashes, 1u);
+    EXPECT_EQ(stats.suppressed_locations, 10u);
+    ASSERT_EQ(stats.suppressed.size(), 1u);
+    EXPECT_EQ(stats.suppressed[0].first, hot_hash);
+    EXPECT_EQ(stats.suppressed[0].second, 10u);
+}
+
+TEST_F(HashIndexTest, ZeroCapDisablesHotHashSuppression) {
+    const uint64_t hash = 333;
+    for (size_t i = 0; i < 10; ++i) {
+        HashLocation loc{};
+        loc.file_id = index.register_file("f" + std::to_string(i) + ".py");
+        loc.start_line = 1;
+        loc.end_line = 5;
+        loc.token_count = 10;
+        index.add_hash(hash, loc);
+    }
+
+    index.set_max_locations_per_hash(0);
+    auto pairs = index.find_clone_pairs();
+
+    EXPECT_EQ(pairs.size(), 10u * 9u / 2u);
+    EXPECT_TRUE(index.get_stats().suppressed.empty());
+}
+
 // =============================================================================
 // Performance Benchmark Tests
 // =============================================================================
@@ -0,0 +1,234 @@
+#include <gtest/gtest.h>
+#include "core/hash_index.hpp"
+#include "core/index_store.hpp"
+#include "core/similarity_detector.hpp"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+using namespace aegis::similarity;
+
+namespace {
+
+HashLocation make_location(uint32_t file_id, uint32_t start_line) {
+    HashLocation loc{};
+    loc.file_id = file_id;
+    loc.start_line = start_line;
+    loc.end_line = start_line + 2;
+    loc.token_start = start_line * 10;
+    loc.token_count = 10;
+    return loc;
+}
+
+void write_file(const std::filesystem::path& path, const std::string& content) {
+    std::ofstream out(path);
+    out << content;
+}
+
+// Enough duplicated logic to exceed min_clone_tokens with defaults
+const char* kCloneBody = R"(
+def process_items(items):
+    total = 0
+    for item in items:
+        if item.value > 0:
+            total += item.value * item.weight
+        else:
+            total -= item.penalty
+    result = total / len(items)
+    return result
+)";
+
+}  // anonymous namespace
+
+// =============================================================================
+// HashIndex removal and serialization
+// =============================================================================
+
+TEST(HashIndexIncremental, RemoveFileDropsOnlyItsLocations) {
+    HashIndex index;
+    const auto id_a = index.register_file("a.py");
+    const auto id_b = index.register_file("b.py");
+
+    index.add_hash(111, make_location(id_a, 1));
+    index.add_hash(111, make_location(id_b, 1));
+    index.add_hash(222, make_location(id_a, 5));
+
+    index.remove_file(id_a);
+
+    // Hash 222 only had locations from file A -> bucket dropped entirely
+    EXPECT_TRUE(index.get_locations(222).empty());
+
+    // Hash 111 keeps file B's location
+    const auto locations = index.get_locations(111);
+    ASSERT_EQ(locations.size(), 1);
+    EXPECT_EQ(locations[0].file_id, id_b);
+
+    // File registration survives so the id can be reused
+    EXPECT_EQ(index.file_count(), 2);
+    EXPECT_EQ(index.register_file("a.py"), id_a);
+}
+
+TEST(HashIndexIncremental, SaveLoadRoundTrip) {
+    HashIndex index;
+    const auto id_a = index.register_file("a.py");
+    const auto id_b = index.register_file("b.py");
+    index.add_hash(111, make_location(id_a, 1));
+    index.add_hash(111, make_location(id_b, 3));
+    index.add_hash(222, make_location(id_b, 7));
+
+    std::stringstream buffer;
+    ASSERT_TRUE(index.save(buffer));
+
+    HashIndex loaded;
+    ASSERT_TRUE(loaded.load(buffer));
+
+    EXPECT_EQ(loaded.file_count(), 2);
+    EXPECT_EQ(loaded.get_file_path(id_a), "a.py");
+    EXPECT_EQ(loaded.get_file_path(id_b), "b.py");
+    EXPECT_EQ(loaded.hash_count(), 2);
+    EXPECT_EQ(loaded.location_count(), 3);
+
+    const auto locations = loaded.get_locations(111);
+    EXPECT_EQ(locations.size(), 2);
+
+    // Registration must continue from the loaded registry
+    EXPECT_EQ(loaded.register_file("c.py"), 2u);
+}
+
+TEST(HashIndexIncremental, LoadRejectsGarbage) {
+    std::stringstream buffer;
+    buffer << "definitely not an index";
+
+    HashIndex index;
+    EXPECT_FALSE(index.load(buffer));
+    EXPECT_EQ(index.file_count(), 0);
+}
+
+// =============================================================================
+// IndexStore persistence
+// =============================================================================
+
+class IndexStoreTest : public ::testing::Test {
+protected:
+    std::filesystem::path temp_dir;
+
+    void SetUp() override {
+        temp_dir = std::filesystem::temp_directory_path() / "aegis_index_store_test";
+        std::filesystem::create_directories(temp_dir);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(temp_dir);
+    }
+};
+
+TEST_F(IndexStoreTest, SaveLoadPreservesFingerprints) {
+    IndexStore store;
+    const auto id = store.index.register_file("a.py");
+    store.index.add_hash(42, make_location(id, 1));
+    store.fingerprints["a.py"] = FileFingerprint{12345, 678, 90};
+
+    const auto store_path = temp_dir / "cache" / "index.bin";
+    ASSERT_TRUE(store.save(store_path));
+
+    IndexStore loaded;
+    ASSERT_TRUE(loaded.load(store_path));
+
+    EXPECT_EQ(loaded.index.file_count(), 1);
+    EXPECT_EQ(loaded.index.location_count(), 1);
+    ASSERT_TRUE(loaded.fingerprints.contains("a.py"));
+    EXPECT_EQ(loaded.fingerprints["a.py"].mtime, 12345);
+    EXPECT_EQ(loaded.fingerprints["a.py"].size, 678);
+    EXPECT_EQ(loaded.fingerprints["a.py"].line_count, 90);
+}
+
+TEST_F(IndexStoreTest, LoadMissingFileFails) {
+    IndexStore store;
+    EXPECT_FALSE(store.load(temp_dir / "does_not_exist.bin"));
+    EXPECT_EQ(store.index.file_count(), 0);
+    EXPECT_TRUE(store.fingerprints.empty());
+}
+
+TEST_F(IndexStoreTest, FingerprintDetectsChange) {
+    const auto file = temp_dir / "f.py";
+    write_file(file, "x = 1\n");
+
+    auto fp1 = IndexStore::fingerprint(file);
+    ASSERT_TRUE(fp1.has_value());
+
+    write_file(file, "x = 1\ny = 2\n");
+    auto fp2 = IndexStore::fingerprint(file);
+    ASSERT_TRUE(fp2.has_value());
+
+    EXPECT_FALSE(fp1->matches(*fp2));
+    EXPECT_TRUE(fp2->matches(*fp2));
+}
+
+// =============================================================================
+// Incremental analysis end-to-end
+// =============================================================================
+
+class IncrementalAnalysisTest : public IndexStoreTest {
+protected:
+    DetectorConfig make_config() {
+        DetectorConfig config;
+        config.incremental = true;
+        config.index_cache_path = (temp_dir / "index.bin").string();
+        return config;
+    }
+};
+
+TEST_F(IncrementalAnalysisTest, ColdRunCreatesStoreAndFindsClones) {
+    write_file(temp_dir / "a.py", kCloneBody);
+    write_file(temp_dir / "b.py", kCloneBody);
+
+    SimilarityDetector detector(make_config());
+    auto report = detector.analyze(temp_dir);
+
+    EXPECT_EQ(report.summary.files_analyzed, 2);
+    EXPECT_GT(report.summary.clone_pairs_found, 0);
+    EXPECT_TRUE(std::filesystem::exists(temp_dir / "index.bin"));
+}
+
+TEST_F(IncrementalAnalysisTest, WarmRunStillReportsClones) {
+    write_file(temp_dir / "a.py", kCloneBody);
+    write_file(temp_dir / "b.py", kCloneBody);
+
+    SimilarityDetector detector(make_config());
+    auto cold = detector.analyze(temp_dir);
+    auto warm = detector.analyze(temp_dir);
+
+    // Second run re-tokenizes nothing but must report the same clones
+    EXPECT_EQ(warm.summary.files_analyzed, cold.summary.files_analyzed);
+    EXPECT_EQ(warm.summary.clone_pairs_found, cold.summary.clone_pairs_found);
+    EXPECT_EQ(warm.summary.total_lines, cold.summary.total_lines);
+}
+
+TEST_F(IncrementalAnalysisTest, ModifiedFileIsReindexed) {
+    write_file(temp_dir / "a.py", kCloneBody);
+    write_file(temp_dir / "b.py", kCloneBody);
+
+    SimilarityDetector detector(make_config());
+    auto cold = detector.analyze(temp_dir);
+    EXPECT_GT(cold.summary.clone_pairs_found, 0);
+
+    // Replace one file with unrelated content: the clones must disappear
+    write_file(temp_dir / "b.py", "import os\n\nprint(os.getcwd())\n");
+
+    auto warm = detector.analyze(temp_dir);
+    EXPECT_EQ(warm.summary.clone_pairs_found, 0);
+}
+
+TEST_F(IncrementalAnalysisTest, DeletedFileEntriesAreRemoved) {
+    write_file(temp_dir / "a.py", kCloneBody);
+    write_file(temp_dir / "b.py", kCloneBody);
+
+    SimilarityDetector detector(make_config());
+    auto cold = detector.analyze(temp_dir);
+    EXPECT_GT(cold.summary.clone_pairs_found, 0);
+
+    std::filesystem::remove(temp_dir / "b.py");
+
+    auto warm = detector.analyze(temp_dir);
+    EXPECT_EQ(warm.summary.clone_pairs_found, 0);
+}
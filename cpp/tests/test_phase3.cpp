@@ -1,9 +1,11 @@
 #include <gtest/gtest.h>
 #include "core/clone_extender.hpp"
+#include "models/report.hpp"
 #include "utils/thread_pool.hpp"
 #include "utils/lru_cache.hpp"
 #include <vector>
 #include <atomic>
+#include <sstream>
 #include <thread>
 #include <chrono>
 
@@ -121,6 +123,104 @@ TEST_F(LRUCacheTest, GetOrCompute) {
     EXPECT_EQ(compute_count, 1);
 }
 
+// =============================================================================
+// Sharded LRU Cache Tests
+// =============================================================================
+
+class ShardedLRUCacheTest : public ::testing::Test {};
+
+TEST_F(ShardedLRUCacheTest, BasicPutAndGet) {
+    ShardedLRUCache<std::string, int> cache(100);
+
+    cache.put("one", 1);
+    cache.put("two", 2);
+
+    EXPECT_EQ(cache.get("one").value(), 1);
+    EXPECT_EQ(cache.get("two").value(), 2);
+    EXPECT_FALSE(cache.get("three").has_value());
+    EXPECT_EQ(cache.size(), 2u);
+}
+
+TEST_F(ShardedLRUCacheTest, CostAwareEviction) {
+    // Single shard so the eviction order is fully observable; each
+    // entry charges its value as cost against a budget of 10
+    ShardedLRUCache<std::string, int> cache(
+        10, 1, [](const int& v) { return static_cast<size_t>(v); });
+
+    cache.put("small", 3);
+    cache.put("medium", 4);
+    cache.put("big", 7);  // Needs room: evicts "small" then "medium"
+
+    EXPECT_FALSE(cache.get("small").has_value());
+    EXPECT_FALSE(cache.get("medium").has_value());
+    EXPECT_EQ(cache.get("big").value(), 7);
+    EXPECT_EQ(cache.get_stats().cost_used, 7u);
+}
+
+TEST_F(ShardedLRUCacheTest, OversizedValueNotCached) {
+    ShardedLRUCache<std::string, int> cache(
+        10, 1, [](const int& v) { return static_cast<size_t>(v); });
+
+    cache.put("keep", 5);
+    cache.put("huge", 50);  // Bigger than the whole budget: rejected
+
+    EXPECT_FALSE(cache.get("huge").has_value());
+    EXPECT_EQ(cache.get("keep").value(), 5);  // Not evicted by the reject
+}
+
+TEST_F(ShardedLRUCacheTest, RemoveReleasesCost) {
+    ShardedLRUCache<std::string, int> cache(
+        10, 1, [](const int& v) { return static_cast<size_t>(v); });
+
+    cache.put("a", 6);
+    EXPECT_TRUE(cache.remove("a"));
+    EXPECT_FALSE(cache.remove("a"));
+
+    cache.put("b", 8);  // Fits because "a" gave its cost back
+    EXPECT_EQ(cache.get("b").value(), 8);
+}
+
+TEST_F(ShardedLRUCacheTest, StatsCountHitsAndMisses) {
+    ShardedLRUCache<std::string, int> cache(100);
+
+    cache.put("key", 1);
+    cache.get("key");
+    cache.get("key");
+    cache.get("absent");
+
+    const auto stats = cache.get_stats();
+    EXPECT_EQ(stats.hits, 2u);
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.current_size, 1u);
+    EXPECT_EQ(stats.capacity, 100u);
+    EXPECT_FLOAT_EQ(stats.hit_rate(), 2.0f / 3.0f);
+}
+
+TEST_F(ShardedLRUCacheTest, ConcurrentMixedAccess) {
+    ShardedLRUCache<int, int> cache(10000);
+
+    std::vector<std::thread> workers;
+    workers.reserve(4);
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&cache, t] {
+            for (int i = 0; i < 500; ++i) {
+                const int key = (t * 500 + i) % 700;  // Overlapping keys
+                cache.put(key, key * 2);
+                auto value = cache.get(key);
+                if (value) {
+                    EXPECT_EQ(*value % 2, 0);
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    EXPECT_LE(cache.size(), 700u);
+    EXPECT_GT(cache.get_stats().hits, 0u);
+}
+
 // =============================================================================
 // Thread Pool Tests
 // =============================================================================
@@ -184,6 +284,35 @@ TEST_F(ThreadPoolTest, Size) {
     EXPECT_EQ(pool.size(), 8);
 }
 
+TEST_F(ThreadPoolTest, SkewedParallelForBalancesAcrossWorkers) {
+    ThreadPool pool(4);
+    std::atomic<int> counter{0};
+
+    // One index is 100x more expensive than the rest; with grain-based
+    // scheduling the other workers must still cover the remaining range
+    pool.parallel_for(0, 64, [&](size_t i) {
+        if (i == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        ++counter;
+    });
+
+    EXPECT_EQ(counter.load(), 64);
+}
+
+TEST_F(ThreadPoolTest, SubmitFromWorkerThread) {
+    ThreadPool pool(2);
+
+    // A task submitting to its own pool must not deadlock: the inner
+    // task lands on the submitting worker's own queue or gets stolen
+    auto outer = pool.submit([&pool]() {
+        auto inner = pool.submit([]() { return 7; });
+        return inner.get();
+    });
+
+    EXPECT_EQ(outer.get(), 7);
+}
+
 TEST_F(ThreadPoolTest, WaitAll) {
     ThreadPool pool(4);
     std::atomic<int> counter{0};
@@ -316,6 +445,42 @@ TEST_F(CloneExtenderTest, AlignmentWithGap) {
     EXPECT_GT(sim, 0.5f);
 }
 
+TEST_F(CloneExtenderTest, AlignmentEarlyExitStaysBelowThreshold) {
+    // Completely disjoint sequences: the kernel may bail out early, but
+    // whatever it returns must still fail the caller's threshold check
+    TokenizedFile file_a = create_test_file({1, 2, 3, 4, 5, 6, 7, 8});
+    TokenizedFile file_b = create_test_file({11, 12, 13, 14, 15, 16, 17, 18});
+
+    float sim = CloneExtender::alignment_similarity(
+        file_a.tokens, 0, 8,
+        file_b.tokens, 0, 8,
+        2, 0.7f
+    );
+
+    EXPECT_LT(sim, 0.7f);
+}
+
+TEST_F(CloneExtenderTest, AlignmentEarlyExitExactAboveThreshold) {
+    // Scores at or above the bail-out threshold must match the full
+    // scan exactly
+    TokenizedFile file_a = create_test_file({1, 2, 3, 4, 5, 6, 7, 8});
+    TokenizedFile file_b = create_test_file({1, 2, 3, 4, 99, 6, 7, 8});
+
+    float full = CloneExtender::alignment_similarity(
+        file_a.tokens, 0, 8,
+        file_b.tokens, 0, 8,
+        2
+    );
+    float early = CloneExtender::alignment_similarity(
+        file_a.tokens, 0, 8,
+        file_b.tokens, 0, 8,
+        2, 0.5f
+    );
+
+    EXPECT_GE(full, 0.5f);
+    EXPECT_FLOAT_EQ(early, full);
+}
+
 TEST_F(CloneExtenderTest, ExtendBasic) {
     CloneExtender::Config config;
     config.max_gap = 2;
@@ -778,6 +943,102 @@ TEST_F(CloneExtenderTest, ExtendAllMissingFile) {
     EXPECT_EQ(result.size(), 1);
 }
 
+TEST_F(CloneExtenderTest, ExtendAllDeduplicatesConvergedSeeds) {
+    CloneExtender::Config config;
+    config.max_gap = 2;
+    config.min_similarity = 0.5f;
+    config.min_tokens = 2;
+    config.lookahead = 5;
+
+    CloneExtender extender(config);
+
+    TokenizedFile file_a = create_test_file({1, 2, 3, 4, 5, 6, 7, 8});
+    file_a.path = "file_a.py";
+    TokenizedFile file_b = create_test_file({1, 2, 3, 4, 5, 6, 7, 8});
+    file_b.path = "file_b.py";
+    std::vector<TokenizedFile> files = {file_a, file_b};
+
+    HashIndex index;
+    index.register_file("file_a.py");
+    index.register_file("file_b.py");
+
+    // Two overlapping seeds in identical files extend to the same region
+    std::vector<ClonePair> pairs;
+    for (uint32_t start : {1u, 2u}) {
+        ClonePair pair{};
+        pair.location_a.file_id = 0;
+        pair.location_a.token_start = start;
+        pair.location_a.token_count = 3;
+        pair.location_a.start_line = start + 1;
+        pair.location_a.end_line = start + 3;
+        pair.location_b = pair.location_a;
+        pair.location_b.file_id = 1;
+        pair.similarity = 1.0f;
+        pair.clone_type = CloneType::TYPE_1;
+        pairs.push_back(pair);
+    }
+
+    auto result = extender.extend_all(pairs, files, index);
+
+    EXPECT_EQ(result.size(), 1);
+}
+
+TEST_F(CloneExtenderTest, ParallelExtendAllMatchesSequential) {
+    CloneExtender::Config config;
+    config.max_gap = 2;
+    config.min_similarity = 0.5f;
+    config.min_tokens = 2;
+    config.lookahead = 5;
+
+    CloneExtender extender(config);
+
+    // Two files with scattered shared runs so seeds extend differently
+    std::vector<uint32_t> hashes_a, hashes_b;
+    for (uint32_t i = 0; i < 600; ++i) {
+        const bool shared = (i / 30) % 2 == 0;
+        hashes_a.push_back(shared ? i % 30 + 1 : 10000 + i);
+        hashes_b.push_back(shared ? i % 30 + 1 : 20000 + i);
+    }
+    TokenizedFile file_a = create_test_file(hashes_a);
+    file_a.path = "file_a.py";
+    TokenizedFile file_b = create_test_file(hashes_b);
+    file_b.path = "file_b.py";
+    std::vector<TokenizedFile> files = {file_a, file_b};
+
+    HashIndex index;
+    index.register_file("file_a.py");
+    index.register_file("file_b.py");
+
+    std::vector<ClonePair> pairs;
+    for (uint32_t i = 0; i < 100; ++i) {
+        const uint32_t start = (i * 5) % 550;
+        ClonePair pair{};
+        pair.location_a.file_id = 0;
+        pair.location_a.token_start = start;
+        pair.location_a.token_count = 5;
+        pair.location_a.start_line = start + 1;
+        pair.location_a.end_line = start + 5;
+        pair.location_b = pair.location_a;
+        pair.location_b.file_id = 1;
+        pair.similarity = 1.0f;
+        pair.clone_type = CloneType::TYPE_1;
+        pairs.push_back(pair);
+    }
+
+    auto sequential = extender.extend_all(pairs, files, index);
+
+    ThreadPool pool(4);
+    auto parallel = extender.extend_all(pairs, files, index, pool);
+
+    ASSERT_EQ(parallel.size(), sequential.size());
+    for (size_t i = 0; i < sequential.size(); ++i) {
+        EXPECT_EQ(parallel[i].location_a.token_start, sequential[i].location_a.token_start);
+        EXPECT_EQ(parallel[i].location_a.token_count, sequential[i].location_a.token_count);
+        EXPECT_EQ(parallel[i].location_b.token_start, sequential[i].location_b.token_start);
+        EXPECT_EQ(parallel[i].location_b.token_count, sequential[i].location_b.token_count);
+    }
+}
+
 // =============================================================================
 // Clone Extender - Boundary and Similarity Tests
 // =============================================================================
@@ -820,6 +1081,10 @@ TEST_F(CloneExtenderTest, JaccardDuplicateHashes) {
     // Should handle duplicates correctly
     EXPECT_GT(sim, 0.0f);
     EXPECT_LT(sim, 1.0f);
+
+    // Multiset semantics exactly: intersection = min-counts (1x2 + 2x2)
+    // = 4, union = 5 + 5 - 4 = 6
+    EXPECT_FLOAT_EQ(sim, 4.0f / 6.0f);
 }
 
 TEST_F(CloneExtenderTest, AlignmentEmptySequence) {
@@ -983,3 +1248,28 @@ TEST_F(ThreadPoolTest, ThreadSafeLRUCache) {
     // Should have many successful operations
     EXPECT_GT(success_count.load(), 500);
 }
+
+// =============================================================================
+// Report Streaming Tests
+// =============================================================================
+
+TEST(ReportStreamTest, StreamedJsonMatchesDomSerialization) {
+    SimilarityReport report;
+
+    ClonePair pair{};
+    pair.location_a = HashLocation{0, 1, 5, 0, 10, 0, 10};
+    pair.location_b = HashLocation{1, 20, 24, 0, 10, 0, 10};
+    pair.clone_type = CloneType::TYPE_1;
+    pair.similarity = 1.0f;
+
+    report.file_table = {"a.py", "b.py"};
+    report.add_clone(pair);
+    report.calculate_hotspots({{0, 50}, {1, 60}});
+    report.finalize(2, 110, 42);
+
+    std::ostringstream streamed;
+    report.to_json_stream(streamed);
+
+    // The streaming path must produce the same document the DOM path does
+    EXPECT_EQ(nlohmann::json::parse(streamed.str()), report.to_json());
+}
@@ -615,3 +615,63 @@ TEST_F(PythonNormalizerTest, IgnoresMultipleImports) {
     // Should have few tokens (just the function definition, no imports)
     EXPECT_LE(result.tokens.size(), 10) << "All imports should be skipped";
 }
+
+// =============================================================================
+// Scanning Fast Path Tests (runs crossing the 16-byte SIMD chunk)
+// =============================================================================
+
+TEST_F(PythonNormalizerTest, LongIdentifierScansAsOneToken) {
+    const std::string name(40, 'x');  // Well past one 16-byte chunk
+    auto result = normalizer.normalize(name + " = 1");
+
+    ASSERT_FALSE(result.tokens.empty());
+    EXPECT_EQ(result.tokens[0].type, TokenType::IDENTIFIER);
+    EXPECT_EQ(result.tokens[0].length, 40);
+
+    // Same hash as the per-character path would produce
+    auto short_run = normalizer.normalize(std::string(3, 'x') + " = 1");
+    EXPECT_EQ(result.tokens[0].normalized_hash, short_run.tokens[0].normalized_hash);
+}
+
+TEST_F(PythonNormalizerTest, LongCommentKeepsLineTracking) {
+    const std::string source =
+        "a = 1  # " + std::string(100, '-') + "\nb = 2\n";
+    auto result = normalizer.normalize(source);
+
+    EXPECT_EQ(result.total_lines, 2);
+    EXPECT_EQ(result.code_lines, 2);
+
+    // The token after the comment's newline sits on line 2
+    ASSERT_GE(result.tokens.size(), 2u);
+    EXPECT_EQ(result.tokens.back().line, 2u);
+}
+
+TEST_F(PythonNormalizerTest, LongStringBodyHashMatchesContent) {
+    const std::string body(50, 'a');
+    auto long_string = normalizer.normalize("s = \"" + body + "\"");
+    auto with_escape = normalizer.normalize("s = \"" + body + "\\n" + body + "\"");
+
+    auto find_string = [](const TokenizedFile& file) {
+        for (const auto& tok : file.tokens) {
+            if (tok.type == TokenType::STRING_LITERAL) return tok;
+        }
+        return NormalizedToken{};
+    };
+
+    const auto plain = find_string(long_string);
+    const auto escaped = find_string(with_escape);
+    EXPECT_EQ(plain.type, TokenType::STRING_LITERAL);
+    EXPECT_EQ(escaped.type, TokenType::STRING_LITERAL);
+
+    // Different contents hash differently; both normalize to $STR
+    EXPECT_NE(plain.original_hash, escaped.original_hash);
+    EXPECT_EQ(plain.normalized_hash, escaped.normalized_hash);
+}
+
+TEST_F(PythonNormalizerTest, LongWhitespaceRunPreservesColumns) {
+    const std::string source = "a" + std::string(30, ' ') + "+ b";
+    auto result = normalizer.normalize(source);
+
+    ASSERT_EQ(result.tokens.size(), 3u);
+    EXPECT_EQ(result.tokens[1].column, 32);  // 1 ('a') + 30 spaces + 1
+}
@@ -188,6 +188,31 @@ TEST_F(RollingHashTest, HashSequenceHandlesSingleWindow) {
     EXPECT_EQ(results[0].second, RollingHash::compute_hash({1, 2, 3}));
 }
 
+TEST_F(RollingHashTest, HashSequenceMatchesPushBasedHashing) {
+    // The batch kernel must produce exactly what repeated push() would
+    std::vector<uint64_t> tokens;
+    for (uint64_t i = 0; i < 100; ++i) {
+        tokens.push_back(i * 2654435761ULL);  // Spread-out values
+    }
+
+    const size_t window_size = 7;
+    auto batch_results = HashSequence::compute_all(tokens, window_size);
+
+    RollingHash hasher(window_size);
+    std::vector<std::pair<size_t, uint64_t>> push_results;
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        if (auto hash = hasher.push(tokens[i]); hash.has_value()) {
+            push_results.emplace_back(i - window_size + 1, *hash);
+        }
+    }
+
+    ASSERT_EQ(batch_results.size(), push_results.size());
+    for (size_t i = 0; i < batch_results.size(); ++i) {
+        EXPECT_EQ(batch_results[i].first, push_results[i].first);
+        EXPECT_EQ(batch_results[i].second, push_results[i].second);
+    }
+}
+
 // =============================================================================
 // Edge Cases
 // =============================================================================
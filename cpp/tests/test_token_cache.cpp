@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include "core/token_cache.hpp"
+#include "core/similarity_detector.hpp"
+#include <filesystem>
+#include <fstream>
+
+using namespace aegis::similarity;
+namespace fs = std::filesystem;
+
+namespace {
+
+const char* kSnippet = R"(def calculate_total(items):
+    total = 0
+    for item in items:
+        total += item.price
+    return total
+)";
+
+}  // anonymous namespace
+
+class TokenCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        root_ = fs::temp_directory_path() / "aegis_token_cache_test";
+        fs::remove_all(root_);
+        fs::create_directories(root_);
+        cache_dir_ = root_ / "cache";
+    }
+
+    void TearDown() override {
+        fs::remove_all(root_);
+    }
+
+    fs::path write_source(const std::string& name, const std::string& content) {
+        fs::path path = root_ / name;
+        std::ofstream out(path);
+        out << content;
+        return path;
+    }
+
+    static TokenizedFile make_tokenized(const fs::path& path) {
+        TokenizedFile file;
+        file.path = path.string();
+        file.total_lines = 5;
+        file.code_lines = 5;
+
+        NormalizedToken token{};
+        token.type = TokenType::IDENTIFIER;
+        token.original_hash = 1234;
+        token.normalized_hash = 42;
+        token.line = 1;
+        token.column = 0;
+        token.length = 3;
+        file.tokens.push_back(token);
+        return file;
+    }
+
+    fs::path root_;
+    fs::path cache_dir_;
+};
+
+TEST_F(TokenCacheTest, StoreAndLoadRoundTrip) {
+    auto source = write_source("a.py", kSnippet);
+    PersistentTokenCache cache(cache_dir_);
+
+    ASSERT_TRUE(cache.store(make_tokenized(source)));
+
+    auto loaded = cache.load(source);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->path, source.string());
+    EXPECT_EQ(loaded->total_lines, 5);
+    ASSERT_EQ(loaded->tokens.size(), 1);
+    EXPECT_EQ(loaded->tokens[0].normalized_hash, 42u);
+    EXPECT_EQ(loaded->tokens[0].type, TokenType::IDENTIFIER);
+}
+
+TEST_F(TokenCacheTest, LoadMissesForUnknownFile) {
+    PersistentTokenCache cache(cache_dir_);
+    EXPECT_FALSE(cache.load(root_ / "never_stored.py").has_value());
+}
+
+TEST_F(TokenCacheTest, StaleEntryIsRejectedAfterSourceChange) {
+    auto source = write_source("a.py", kSnippet);
+    PersistentTokenCache cache(cache_dir_);
+    ASSERT_TRUE(cache.store(make_tokenized(source)));
+
+    // Change content and push mtime forward so the fingerprint differs
+    write_source("a.py", std::string(kSnippet) + "\nextra = 1\n");
+    fs::last_write_time(source, fs::last_write_time(source) + std::chrono::seconds(2));
+
+    EXPECT_FALSE(cache.load(source).has_value());
+}
+
+TEST_F(TokenCacheTest, WarmDetectorRunProducesSameReport) {
+    // Different bytes (trailing marker) so the identical-file dedup
+    // pass doesn't fold the pair before matching sees it
+    write_source("a.py", kSnippet);
+    write_source("b.py", std::string(kSnippet) + "\nmarker_b = 1\n");
+
+    DetectorConfig cfg;
+    cfg.extensions = {".py"};
+    cfg.window_size = 5;
+    cfg.min_clone_tokens = 10;
+    cfg.token_cache_dir = (cache_dir_).string();
+
+    SimilarityDetector cold(cfg);
+    auto cold_report = cold.analyze(root_);
+
+    // Second detector instance: tokens must come from the on-disk cache
+    SimilarityDetector warm(cfg);
+    auto warm_report = warm.analyze(root_);
+
+    EXPECT_GT(cold_report.clones.size(), 0);
+    EXPECT_EQ(warm_report.clones.size(), cold_report.clones.size());
+    EXPECT_EQ(warm_report.summary.total_lines, cold_report.summary.total_lines);
+}